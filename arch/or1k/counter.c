@@ -4,7 +4,12 @@
  */
 
 #include <counter.h>
+#include <division.h>
 #include <spr.h>
+#include <platform/time.h>
+
+/* Zero until the clock driver measures the CPU clock during init. */
+static uint32_t cycle_counter_khz;
 
 void
 cycle_counter_init(void)
@@ -18,3 +23,18 @@ cycle_counter_read(void)
 {
 	return mfspr(SPR_TICK_TTCR_ADDR);
 }
+
+uint32_t
+cycle_counter_rate_khz(void)
+{
+	return cycle_counter_khz ? cycle_counter_khz : CPUCLK_kHz;
+}
+
+void
+cycle_counter_set_rate(uint32_t rate)
+{
+	uint32_t khz = udiv_round(rate, 1000);
+
+	/* Round up very slow clocks, so delays are never shortened to zero. */
+	cycle_counter_khz = khz ? khz : 1;
+}
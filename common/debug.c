@@ -6,6 +6,7 @@
 #include <ctype.h>
 #include <debug.h>
 #include <division.h>
+#include <log_buffer.h>
 #include <serial.h>
 #include <stdarg.h>
 #include <stdbool.h>
@@ -14,6 +15,8 @@
 #define BYTES_PER_ROW  16
 #define BYTES_PER_WORD sizeof(uint32_t)
 
+#if !CONFIG(DEBUG_TOKENIZED_LOG)
+
 static char *prefixes[LOG_LEVELS] = {
 	"SCP/ERR: ",
 	"SCP/WRN: ",
@@ -24,6 +27,19 @@ static char *prefixes[LOG_LEVELS] = {
 static void print_number(uint32_t num, int base, int width, bool zero);
 static void print_signed(int32_t num, int base, int width, bool zero);
 
+#endif
+
+/* Whether or not the serial port was ready at the start of the message. */
+static bool use_serial;
+
+static void
+log_putc(char c)
+{
+	log_buffer_putc(c);
+	if (use_serial)
+		serial_putc(c);
+}
+
 void
 hexdump(uintptr_t addr, uint32_t bytes)
 {
@@ -44,12 +60,76 @@ hexdump(uintptr_t addr, uint32_t bytes)
 		 * individual bytes, we must reverse each group of 4 bytes. */
 		for (int i = 0; i < BYTES_PER_ROW; ++i) {
 			char c = ((char *)addr)[i ^ 3];
-			serial_putc(isprint(c) ? c : '.');
+			log_putc(isprint(c) ? c : '.');
 		}
-		serial_putc('\n');
+		log_putc('\n');
+
+		/* Avoid overflowing the output buffer with large dumps. */
+		if (use_serial)
+			serial_flush();
 	}
 }
 
+#if CONFIG(DEBUG_TOKENIZED_LOG)
+
+/* These values must match those in tools/logdecode.c. */
+#define LOG_RECORD_MAGIC 0xff
+#define LOG_RECORD_SIZE  (2 + BYTES_PER_WORD * (1 + LOG_MAX_ARGS))
+
+static uint8_t *
+put_word(uint8_t *p, uint32_t word)
+{
+	/* Words are always sent least significant byte first. */
+	*p++ = word;
+	*p++ = word >> 8;
+	*p++ = word >> 16;
+	*p++ = word >> 24;
+
+	return p;
+}
+
+void
+log_token(uint32_t header, uintptr_t token, ...)
+{
+	uint8_t  record[LOG_RECORD_SIZE];
+	uint8_t *p     = record;
+	uint32_t nargs = header >> 8;
+	va_list  args;
+
+	assert(nargs <= LOG_MAX_ARGS);
+
+	use_serial = serial_ready();
+
+	*p++ = LOG_RECORD_MAGIC;
+	*p++ = nargs;
+	p    = put_word(p, token);
+	va_start(args, token);
+	while (nargs--)
+		p = put_word(p, va_arg(args, uintptr_t));
+	va_end(args);
+
+	/* Write the record as a unit, so it is never partially dropped. */
+	log_buffer_write(record, p - record);
+	if (!use_serial)
+		return;
+	serial_write(record, p - record);
+
+	/* Errors are often followed by a trap, so write them out now. */
+	if ((uint8_t)header == *LOG_STRING_ERROR)
+		serial_flush();
+}
+
+#else
+
+static void
+log_puts(const char *s)
+{
+	char c;
+
+	while ((c = *s++))
+		log_putc(c);
+}
+
 void
 log(const char *fmt, ...)
 {
@@ -61,23 +141,24 @@ log(const char *fmt, ...)
 
 	assert(fmt);
 
-	if (!serial_ready())
+	use_serial = serial_ready();
+	if (!use_serial && !CONFIG(DEBUG_LOG_BUFFER))
 		return;
 
 	level = *fmt - 1;
 	if (level < LOG_LEVELS) {
-		serial_puts(prefixes[level]);
+		log_puts(prefixes[level]);
 		++fmt;
 	}
 	va_start(args, fmt);
 	while ((c = *fmt++)) {
 		if (c != '%') {
-			serial_putc(c);
+			log_putc(c);
 			continue;
 		}
 		if (*fmt == '%') {
 			++fmt;
-			serial_putc(c);
+			log_putc(c);
 			continue;
 		}
 		arg   = va_arg(args, uintptr_t);
@@ -86,7 +167,7 @@ log(const char *fmt, ...)
 conversion:
 		switch ((c = *fmt++)) {
 		case 'c':
-			serial_putc(arg);
+			log_putc(arg);
 			break;
 		case 'd':
 		case 'i':
@@ -94,7 +175,7 @@ conversion:
 			break;
 		case 'p':
 			/* "%p" behaves like "0x%08x". */
-			serial_puts("0x");
+			log_puts("0x");
 			print_number(arg, 16, 2 * sizeof(arg), true);
 			break;
 		case 'x':
@@ -102,7 +183,7 @@ conversion:
 			break;
 		case 's':
 			assert(arg);
-			serial_puts((const char *)arg);
+			log_puts((const char *)arg);
 			break;
 		case 'u':
 			print_number(arg, 10, width, zero);
@@ -118,7 +199,11 @@ conversion:
 	}
 	va_end(args);
 	if (level < LOG_LEVELS)
-		serial_putc('\n');
+		log_putc('\n');
+
+	/* Errors are often followed by a trap, so write them out now. */
+	if (use_serial && level == LOG_LEVEL_ERROR)
+		serial_flush();
 }
 
 static void
@@ -132,18 +217,20 @@ print_number(uint32_t num, int base, int width, bool zero)
 		digits[i++] = chars[udivmod(&num, base)];
 	} while (num);
 	while (width-- > i)
-		serial_putc(zero ? '0' : ' ');
+		log_putc(zero ? '0' : ' ');
 	while (i--)
-		serial_putc(digits[i]);
+		log_putc(digits[i]);
 }
 
 static void
 print_signed(int32_t num, int base, int width, bool zero)
 {
 	if (num < 0) {
-		serial_putc('-');
+		log_putc('-');
 		print_number(-num, base, width ? width - 1 : width, zero);
 	} else {
 		print_number(num, base, width, zero);
 	}
 }
+
+#endif
@@ -5,51 +5,51 @@
 
 #include <debug.h>
 #include <division.h>
+#include <ktime.h>
 #include <regmap.h>
 #include <stdint.h>
-#include <timeout.h>
 #include <util.h>
 #include <mfd/axp20x.h>
 
-#define MEASUREMENT_INTERVAL (30 * USEC_PER_SEC) /* 30s */
+#define MEASUREMENT_INTERVAL 30 /* seconds */
 
-static uint32_t timeout;
+static uint64_t deadline;
 
 void
 debug_print_battery(void)
 {
 	const struct regmap *map = &axp20x.map;
 	uint32_t current, voltage;
-	uint8_t  hi, lo, val;
+	uint8_t  regs[2];
 
-	if (!timeout_expired(timeout))
+	if (!ktime_expired(deadline))
 		return;
 	if (regmap_user_probe(map))
 		return;
 
+	/* Read the power source and charger status registers together. */
+	if (regmap_read_bulk(map, 0x00, regs, sizeof(regs)))
+		goto err_put_mfd;
 	/* Battery present? */
-	if (regmap_read(map, 0x01, &val) || !(val & BIT(5)))
+	if (!(regs[1] & BIT(5)))
 		goto err_put_mfd;
 	/* Battery discharging? */
-	if (regmap_read(map, 0x00, &val) || (val & BIT(2)))
+	if (regs[0] & BIT(2))
 		goto err_put_mfd;
 
-	if (regmap_read(map, 0x78, &hi))
-		goto err_put_mfd;
-	if (regmap_read(map, 0x79, &lo))
+	/* Each ADC result is split across a pair of registers. */
+	if (regmap_read_bulk(map, 0x78, regs, sizeof(regs)))
 		goto err_put_mfd;
-	voltage = udiv_round(((hi << 4) | (lo & 0xf)) * 1100, 1000);
+	voltage = udiv_round(((regs[0] << 4) | (regs[1] & 0xf)) * 1100, 1000);
 
-	if (regmap_read(map, 0x7c, &hi))
-		goto err_put_mfd;
-	if (regmap_read(map, 0x7d, &lo))
+	if (regmap_read_bulk(map, 0x7c, regs, sizeof(regs)))
 		goto err_put_mfd;
-	current = (hi << 4) | (lo & 0xf);
+	current = (regs[0] << 4) | (regs[1] & 0xf);
 
 	info("Using %u mW (%u mA @ %u mV)",
 	     udiv_round(current * voltage, 1000), current, voltage);
 
 err_put_mfd:
 	regmap_user_release(map);
-	timeout = timeout_set(MEASUREMENT_INTERVAL);
+	deadline = ktime_add_sec(ktime_get(), MEASUREMENT_INTERVAL);
 }
@@ -6,23 +6,125 @@
 #include <counter.h>
 #include <debug.h>
 #include <division.h>
-#include <system.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <util.h>
 
-#define ITERATIONS 10000
+static const char *const state_names[LATENCY_STATES] = {
+	[LATENCY_AWAKE]  = "awake",
+	[LATENCY_ASLEEP] = "asleep",
+	[LATENCY_OFF]    = "off",
+};
 
-static uint32_t cycles;
-static uint32_t iterations;
+static struct latency_stats stats[LATENCY_STATES];
+static uint32_t last_cycles;
+/* Stored plus one, so the initial value of zero matches no state. */
 static uint8_t  last_state;
 
+/**
+ * Find the histogram bucket for a latency. Bucket n counts latencies less than
+ * 2^(n + LATENCY_BUCKET_SHIFT), except the last bucket counts everything else.
+ */
+static uint32_t
+latency_bucket(uint32_t cycles)
+{
+	uint32_t bucket = 0;
+
+	cycles >>= LATENCY_BUCKET_SHIFT;
+	while (cycles && bucket < LATENCY_BUCKETS - 1) {
+		cycles >>= 1;
+		++bucket;
+	}
+
+	return bucket;
+}
+
+void
+debug_discard_latency(void)
+{
+	last_state = 0;
+}
+
+void
+debug_record_latency(uint8_t state)
+{
+	uint32_t now = cycle_counter_read();
+	struct latency_stats *s;
+	uint32_t cycles;
+
+	/* Do not count iterations that include a state transition. */
+	if (state + 1 != last_state) {
+		last_cycles = now;
+		last_state  = state + 1;
+		return;
+	}
+
+	s           = &stats[state];
+	cycles      = now - last_cycles;
+	last_cycles = now;
+
+	if (!s->iterations++ || cycles < s->min)
+		s->min = cycles;
+	if (cycles > s->max)
+		s->max = cycles;
+	++s->histogram[latency_bucket(cycles)];
+
+	/* Halve the running sum on overflow, so the mean favors recent data. */
+	if (s->sum + cycles < s->sum) {
+		s->sum     >>= 1;
+		s->samples >>= 1;
+	}
+	s->sum += cycles;
+	++s->samples;
+}
+
+const struct latency_stats *
+debug_get_latency_stats(uint8_t state)
+{
+	if (state >= LATENCY_STATES)
+		return NULL;
+
+	return &stats[state];
+}
+
+uint32_t
+debug_latency_mean(const struct latency_stats *s)
+{
+	return s->samples ? udiv_round(s->sum, s->samples) : 0;
+}
+
 void
-debug_print_latency(uint8_t current_state)
+debug_print_latency_stats(void)
 {
-	if (current_state != last_state) {
-		cycles     = cycle_counter_read();
-		iterations = 0;
-		last_state = current_state;
-	} else if (iterations < ITERATIONS && ++iterations == ITERATIONS) {
-		info("State %u: %u cycles/iteration", current_state,
-		     udiv_round(cycle_counter_read() - cycles, ITERATIONS));
+	for (uint8_t i = 0; i < LATENCY_STATES; ++i) {
+		const struct latency_stats *s = &stats[i];
+
+		if (!s->iterations)
+			continue;
+		log("%s: %u iterations, min/mean/max %u/%u/%u cycles\n",
+		    state_names[i], s->iterations, s->min,
+		    debug_latency_mean(s), s->max);
+		for (uint32_t b = 0; b < LATENCY_BUCKETS; ++b) {
+			bool last = b == LATENCY_BUCKETS - 1;
+
+			if (!s->histogram[b])
+				continue;
+			log("  %s 2^%u: %u\n", last ? ">=" : "< ",
+			    b + LATENCY_BUCKET_SHIFT - last, s->histogram[b]);
+		}
 	}
 }
+
+void
+debug_reset_latency_stats(void)
+{
+	/* Use a volatile pointer to avoid emitting a call to memset(). */
+	volatile uint32_t *word = (volatile uint32_t *)stats;
+
+	while (word < (volatile uint32_t *)&stats[LATENCY_STATES])
+		*word++ = 0;
+
+	/* Also discard the iteration in progress. */
+	debug_discard_latency();
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <log_buffer.h>
+#include <mmio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <platform/memory.h>
+
+#define LOG_BUF_DATA_SIZE (LOG_BUF_SIZE - sizeof(struct log_buffer))
+
+static_assert(LOG_BUF_SIZE % sizeof(uint32_t) == 0,
+              "Log buffer size must be a multiple of 4");
+
+static struct log_buffer *const log_buf = (void *)LOG_BUF_BASE;
+
+void
+log_buffer_init(void)
+{
+	if (log_buf->magic == LOG_BUFFER_MAGIC &&
+	    log_buf->size == LOG_BUF_DATA_SIZE &&
+	    log_buf->index < LOG_BUF_DATA_SIZE)
+		return;
+
+	log_buf->magic = 0;
+	log_buf->size  = LOG_BUF_DATA_SIZE;
+	log_buf->index = 0;
+	log_buf->count = 0;
+	log_buf->magic = LOG_BUFFER_MAGIC;
+}
+
+void
+log_buffer_putc(char c)
+{
+	uint32_t index = log_buf->index;
+
+	/* Write each byte where an ARM CPU expects to find it. */
+	mmio_write_8((uintptr_t)&log_buf->data[index], c);
+	if (++index == LOG_BUF_DATA_SIZE)
+		index = 0;
+	log_buf->index = index;
+	log_buf->count++;
+}
+
+void
+log_buffer_write(const uint8_t *data, uint32_t size)
+{
+	while (size--)
+		log_buffer_putc(*data++);
+}
@@ -67,6 +67,15 @@ run_command(const char *cmd)
 		if (parse_hex(&cmd, &addr) && parse_hex(&cmd, &len))
 			hexdump(addr, len);
 		return;
+	case 'L':
+		/* Latency: "L", print and reset statistics. */
+		debug_print_latency_stats();
+		debug_reset_latency_stats();
+		return;
+	case 'l':
+		/* Latency: "l", print statistics. */
+		debug_print_latency_stats();
+		return;
 	case 'm':
 		/* MMIO: "m xxxxxxxx" or "m xxxxxxxx xxxxxxxx", bare hex. */
 		if (parse_hex(&cmd, &addr)) {
@@ -0,0 +1,179 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <division.h>
+#include <energy.h>
+#include <ktime.h>
+#include <regmap.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
+#include <mfd/axp20x.h>
+#include <platform/memory.h>
+
+#define POWER_STATUS_REG   0x00
+#define CHARGE_STATUS_REG  0x01
+#define BAT_VOLTAGE_REG    0x78
+#define BAT_DISCHARGE_REG  0x7c
+#define FUEL_GAUGE_REG     0xb9
+
+static_assert(sizeof(struct energy_stats) <= ENERGY_SIZE,
+              "Energy accounting data does not fit in its memory region");
+
+static struct energy_stats *const stats = (void *)ENERGY_BASE;
+
+/* The time up to which energy usage has been accounted. */
+static uint64_t last_update;
+/* The time of the next battery measurement. */
+static uint64_t deadline;
+/* The most recent power measurement in the current state, or zero. */
+static uint32_t state_mW;
+/* The state passed to the last call, plus one, so zero means none. */
+static uint8_t  last_state;
+
+/**
+ * Read the battery voltage and discharge current from the PMIC.
+ *
+ * @return The battery power usage in milliwatts, or zero if the battery is
+ *         absent, charging, or cannot be measured.
+ */
+static uint32_t
+energy_measure(void)
+{
+	const struct regmap *map = &axp20x.map;
+	uint32_t current, voltage, power = 0;
+	uint8_t  regs[2];
+
+	if (regmap_user_probe(map))
+		return 0;
+
+	/* Battery present and discharging? */
+	if (regmap_read_bulk(map, POWER_STATUS_REG, regs, sizeof(regs)))
+		goto out;
+	if (!(regs[1] & BIT(5)) || (regs[0] & BIT(2)))
+		goto out;
+
+	if (regmap_read_bulk(map, BAT_VOLTAGE_REG, regs, sizeof(regs)))
+		goto out;
+	voltage = udiv_round(((regs[0] << 4) | (regs[1] & 0xf)) * 1100, 1000);
+
+	if (regmap_read_bulk(map, BAT_DISCHARGE_REG, regs, sizeof(regs)))
+		goto out;
+	current = (regs[0] << 4) | (regs[1] & 0xf);
+
+	/* Bit 7 means the fuel gauge result is valid. */
+	if (!regmap_read(map, FUEL_GAUGE_REG, regs) && (regs[0] & BIT(7)))
+		stats->last_percent = regs[0] & 0x7f;
+
+	stats->last_mV = voltage;
+	stats->last_mA = current;
+	power = udiv_round(current * voltage, 1000);
+
+out:
+	regmap_user_release(map);
+
+	return power;
+}
+
+/**
+ * Account for the time since the last update in the given state.
+ */
+static void
+energy_account(uint8_t state, uint64_t now)
+{
+	struct energy_state_stats *s = &stats->states[state];
+	uint64_t elapsed = now - last_update;
+	uint32_t us, ms;
+
+	/* Updates happen at least every measurement interval, so this only
+	 * saturates if the main loop was stalled for over an hour. */
+	us = elapsed >> 32 ? UINT32_MAX : (uint32_t)elapsed;
+	ms = us / 1000;
+
+	s->time_ms += ms;
+	if (state_mW) {
+		s->measured_ms += ms;
+		/* The product overflows 32 bits after about an hour at 1 W. */
+		s->energy_uJ   += mul_u32_u32(state_mW, ms);
+	}
+	/* Carry the partial millisecond into the next update. */
+	last_update = now - us % 1000;
+}
+
+uint32_t
+energy_average_mW(const struct energy_state_stats *s)
+{
+	uint64_t energy = s->energy_uJ;
+	uint32_t ms     = s->measured_ms;
+
+	/* Scale both values down until the division fits in 32 bits. */
+	while (energy >> 32) {
+		energy >>= 1;
+		ms     >>= 1;
+	}
+
+	return ms ? (uint32_t)energy / ms : 0;
+}
+
+const struct energy_stats *
+energy_get_stats(void)
+{
+	return stats;
+}
+
+void
+energy_init(void)
+{
+	if (stats->magic == ENERGY_STATS_MAGIC)
+		return;
+
+	energy_reset();
+}
+
+void
+energy_reset(void)
+{
+	volatile uint32_t *words = (volatile uint32_t *)stats;
+
+	/* Avoid a call to memset(), which is not available. */
+	while (words < (volatile uint32_t *)(stats + 1))
+		*words++ = 0;
+	stats->magic = ENERGY_STATS_MAGIC;
+}
+
+void
+energy_update(uint8_t state)
+{
+	uint64_t now;
+
+	if (last_state != state + 1) {
+		now = ktime_get();
+		if (last_state)
+			energy_account(last_state - 1, now);
+		else
+			last_update = now;
+		if (last_state == ENERGY_ASLEEP + 1 && state == ENERGY_AWAKE)
+			stats->wakeups++;
+		stats->states[state].entries++;
+		last_state = state + 1;
+		state_mW   = 0;
+		deadline   = ktime_add_sec(now, CONFIG_ENERGY_STATS_INTERVAL);
+		return;
+	}
+
+	if (!ktime_expired(deadline))
+		return;
+
+	/* While the system is awake, the rich OS owns the PMIC bus. So only
+	 * time is accounted; the power usage is unknown. */
+	now = ktime_get();
+	if (state != ENERGY_AWAKE) {
+		state_mW = energy_measure();
+		if (state_mW)
+			stats->states[state].samples++;
+	}
+	energy_account(state, now);
+	deadline = ktime_add_sec(now, CONFIG_ENERGY_STATS_INTERVAL);
+}
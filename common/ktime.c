@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <counter.h>
+#include <division.h>
+#include <ktime.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <platform/time.h>
+
+/* The monotonic time, in microseconds, as of the last update. */
+static uint64_t ktime_us;
+/* The cycle counter value at the last update. */
+static uint32_t ktime_cycles;
+/* The system counter value at the last update, if it is in use. */
+static uint32_t ktime_ticks;
+/* Whether the system counter was running at the last update. */
+static bool     ktime_use_ticks;
+/* The fraction of a microsecond not yet added, as a numerator over kHz. */
+static uint32_t ktime_frac;
+
+uint64_t
+ktime_add_ms(uint64_t time, uint32_t mseconds)
+{
+	return time + mul_u32_u32(mseconds, 1000);
+}
+
+uint64_t
+ktime_add_sec(uint64_t time, uint32_t seconds)
+{
+	return time + mul_u32_u32(seconds, 1000000);
+}
+
+bool
+ktime_expired(uint64_t deadline)
+{
+	return ktime_get() >= deadline;
+}
+
+uint64_t
+ktime_get(void)
+{
+	ktime_poll();
+
+	return ktime_us;
+}
+
+void
+ktime_poll(void)
+{
+	uint32_t now = cycle_counter_read();
+	uint32_t khz, ticks;
+	uint32_t ms, rem;
+
+	if (ktime_use_ticks) {
+		uint32_t ticks_now = system_counter_read();
+
+		khz         = REFCLK_KHZ;
+		ticks       = ticks_now - ktime_ticks;
+		ktime_ticks = ticks_now;
+	} else {
+		khz   = cycle_counter_rate_khz();
+		ticks = now - ktime_cycles;
+	}
+
+	/* Split the conversion to avoid overflow, keeping the remainder. */
+	ms  = ticks / khz;
+	rem = ticks % khz * 1000 + ktime_frac;
+
+	ktime_us    += mul_u32_u32(ms, 1000) + rem / khz;
+	ktime_cycles = now;
+	ktime_frac   = rem % khz;
+}
+
+void
+ktime_use_system_counter(bool enable)
+{
+	/* Account for the time so far using the old counter. */
+	ktime_poll();
+
+	ktime_ticks     = system_counter_read();
+	ktime_use_ticks = enable;
+	/* The remainder is in units of the old counter, so drop it. */
+	ktime_frac      = 0;
+}
@@ -4,9 +4,12 @@
  */
 
 #include <bitfield.h>
+#include <cec.h>
+#include <cir.h>
 #include <css.h>
 #include <debug.h>
 #include <device.h>
+#include <energy.h>
 #include <scpi.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -15,6 +18,7 @@
 #include <system.h>
 #include <util.h>
 #include <version.h>
+#include <gpio/sunxi-gpio.h>
 
 enum {
 	/** Do not send a reply to this command. */
@@ -168,6 +172,167 @@ scpi_cmd_set_sys_power_handler(uint32_t *rx_payload,
 	return SCPI_OK;
 }
 
+/*
+ * Handler for SCPI_CMD_GET_LATENCY_STATS: Get main loop latency statistics.
+ *
+ * The request selects a stable system state. The reply contains the iteration
+ * count, the minimum, mean, and maximum latency, and the histogram buckets.
+ */
+static int
+scpi_cmd_get_latency_stats_handler(uint32_t *rx_payload,
+                                   uint32_t *tx_payload, uint16_t *tx_size)
+{
+	const struct latency_stats *stats;
+
+	if (!CONFIG(DEBUG_LATENCY_STATS))
+		return SCPI_E_SUPPORT;
+	if (!(stats = debug_get_latency_stats(rx_payload[0])))
+		return SCPI_E_PARAM;
+
+	tx_payload[0] = stats->iterations;
+	tx_payload[1] = stats->min;
+	tx_payload[2] = debug_latency_mean(stats);
+	tx_payload[3] = stats->max;
+	for (uint32_t i = 0; i < LATENCY_BUCKETS; ++i)
+		tx_payload[4 + i] = stats->histogram[i];
+
+	*tx_size = (4 + LATENCY_BUCKETS) * sizeof(*tx_payload);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_RESET_LATENCY_STATS: Reset latency statistics.
+ */
+static int
+scpi_cmd_reset_latency_stats_handler(uint32_t *rx_payload UNUSED,
+                                     uint32_t *tx_payload UNUSED,
+                                     uint16_t *tx_size UNUSED)
+{
+	if (!CONFIG(DEBUG_LATENCY_STATS))
+		return SCPI_E_SUPPORT;
+
+	debug_reset_latency_stats();
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_ENERGY_STATS: Get battery energy statistics.
+ *
+ * The request selects a system state. The reply contains the wakeup count,
+ * the last battery voltage, current, and charge percentage, followed by the
+ * total and measured time, the energy used (low and high words), the entry
+ * and sample counts, and the average power for that state.
+ */
+static int
+scpi_cmd_get_energy_stats_handler(uint32_t *rx_payload,
+                                  uint32_t *tx_payload, uint16_t *tx_size)
+{
+	const struct energy_state_stats *s;
+	const struct energy_stats *stats;
+
+	if (!CONFIG(ENERGY_STATS))
+		return SCPI_E_SUPPORT;
+	if (rx_payload[0] >= ENERGY_STATES)
+		return SCPI_E_PARAM;
+
+	stats = energy_get_stats();
+	s     = &stats->states[rx_payload[0]];
+
+	tx_payload[0]  = stats->wakeups;
+	tx_payload[1]  = stats->last_mV;
+	tx_payload[2]  = stats->last_mA;
+	tx_payload[3]  = stats->last_percent;
+	tx_payload[4]  = s->time_ms;
+	tx_payload[5]  = s->measured_ms;
+	tx_payload[6]  = s->energy_uJ;
+	tx_payload[7]  = s->energy_uJ >> 32;
+	tx_payload[8]  = s->entries;
+	tx_payload[9]  = s->samples;
+	tx_payload[10] = energy_average_mW(s);
+
+	*tx_size = 11 * sizeof(*tx_payload);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_RESET_ENERGY_STATS: Reset battery energy statistics.
+ */
+static int
+scpi_cmd_reset_energy_stats_handler(uint32_t *rx_payload UNUSED,
+                                    uint32_t *tx_payload UNUSED,
+                                    uint16_t *tx_size UNUSED)
+{
+	if (!CONFIG(ENERGY_STATS))
+		return SCPI_E_SUPPORT;
+
+	energy_reset();
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_SET_GPIO_WAKE: Set port L wakeup pins.
+ *
+ * The request contains a bitmask of port L pins and the trigger condition.
+ * An empty bitmask disables GPIO wakeup, and a bitmask with all bits set
+ * restores the default configuration.
+ */
+static int
+scpi_cmd_set_gpio_wake_handler(uint32_t *rx_payload,
+                               uint32_t *tx_payload UNUSED,
+                               uint16_t *tx_size UNUSED)
+{
+	if (!CONFIG(R_PIO_WAKE))
+		return SCPI_E_SUPPORT;
+	if (rx_payload[1] > UINT8_MAX ||
+	    sunxi_gpio_set_wake(rx_payload[0], rx_payload[1]))
+		return SCPI_E_PARAM;
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_SET_CIR_WAKE_CODE: Set a CIR wakeup scan code.
+ *
+ * The request contains the table index, the protocol, and the scan code.
+ * A scan code of zero clears the table entry.
+ */
+static int
+scpi_cmd_set_cir_wake_code_handler(uint32_t *rx_payload,
+                                   uint32_t *tx_payload UNUSED,
+                                   uint16_t *tx_size UNUSED)
+{
+	if (!CONFIG(CIR))
+		return SCPI_E_SUPPORT;
+	if (rx_payload[0] > UINT8_MAX || rx_payload[1] > UINT8_MAX ||
+	    cir_set_wake_code(rx_payload[0], rx_payload[1], rx_payload[2]))
+		return SCPI_E_PARAM;
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_SET_CEC_WAKE: Set CEC wakeup messages.
+ *
+ * The request contains a bitmask of wakeup messages and a bitmask of the
+ * logical addresses allowed to send them.
+ */
+static int
+scpi_cmd_set_cec_wake_handler(uint32_t *rx_payload,
+                              uint32_t *tx_payload UNUSED,
+                              uint16_t *tx_size UNUSED)
+{
+	if (!CONFIG(CEC))
+		return SCPI_E_SUPPORT;
+	if (cec_set_wake_filter(rx_payload[0], rx_payload[1]))
+		return SCPI_E_PARAM;
+
+	return SCPI_OK;
+}
+
 /*
  * The list of supported SCPI commands.
  */
@@ -194,6 +359,56 @@ static const struct scpi_cmd scpi_cmds[] = {
 	},
 };
 
+/*
+ * The list of supported vendor-specific SCPI commands.
+ */
+static const struct scpi_cmd scpi_vendor_cmds[] = {
+	[SCPI_CMD_GET_LATENCY_STATS - SCPI_CMD_VENDOR_BASE] = {
+		.handler = scpi_cmd_get_latency_stats_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCPI_CMD_RESET_LATENCY_STATS - SCPI_CMD_VENDOR_BASE] = {
+		.handler = scpi_cmd_reset_latency_stats_handler,
+	},
+	[SCPI_CMD_GET_ENERGY_STATS - SCPI_CMD_VENDOR_BASE] = {
+		.handler = scpi_cmd_get_energy_stats_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCPI_CMD_RESET_ENERGY_STATS - SCPI_CMD_VENDOR_BASE] = {
+		.handler = scpi_cmd_reset_energy_stats_handler,
+	},
+	[SCPI_CMD_SET_GPIO_WAKE - SCPI_CMD_VENDOR_BASE] = {
+		.handler = scpi_cmd_set_gpio_wake_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCPI_CMD_SET_CIR_WAKE_CODE - SCPI_CMD_VENDOR_BASE] = {
+		.handler = scpi_cmd_set_cir_wake_code_handler,
+		.rx_size = 3 * sizeof(uint32_t),
+	},
+	[SCPI_CMD_SET_CEC_WAKE - SCPI_CMD_VENDOR_BASE] = {
+		.handler = scpi_cmd_set_cec_wake_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+};
+
+/*
+ * Look up a command in the standard or vendor-specific list.
+ */
+static const struct scpi_cmd *
+scpi_get_cmd(uint8_t command)
+{
+	if (command >= SCPI_CMD_VENDOR_BASE) {
+		command -= SCPI_CMD_VENDOR_BASE;
+		if (command >= ARRAY_SIZE(scpi_vendor_cmds))
+			return NULL;
+		return &scpi_vendor_cmds[command];
+	}
+	if (command >= ARRAY_SIZE(scpi_cmds))
+		return NULL;
+
+	return &scpi_cmds[command];
+}
+
 /*
  * Generic SCPI command handling function.
  */
@@ -210,10 +425,9 @@ scpi_handle_cmd(uint8_t client, struct scpi_mem *mem)
 	tx_msg->size    = 0;
 	tx_msg->status  = SCPI_E_SUPPORT;
 
-	/* Avoid reading past the end of the array; reply with the error. */
-	if (rx_msg->command >= ARRAY_SIZE(scpi_cmds))
+	/* Avoid reading past the end of the arrays; reply with the error. */
+	if (!(cmd = scpi_get_cmd(rx_msg->command)))
 		return true;
-	cmd = &scpi_cmds[rx_msg->command];
 
 	/* Update the command status and payload based on the message. */
 	if ((cmd->flags & FLAG_SECURE_ONLY) && client != SCPI_CLIENT_EL3) {
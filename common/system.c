@@ -5,23 +5,30 @@
 
 #include <cec.h>
 #include <cir.h>
+#include <clock.h>
 #include <counter.h>
 #include <css.h>
 #include <debug.h>
 #include <delay.h>
 #include <device.h>
 #include <dram.h>
+#include <energy.h>
+#include <error.h>
 #include <exception.h>
 #include <irq.h>
+#include <ktime.h>
+#include <log_buffer.h>
 #include <pmic.h>
 #include <regulator.h>
 #include <regulator_list.h>
 #include <scpi.h>
 #include <serial.h>
 #include <simple_device.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <steps.h>
 #include <system.h>
+#include <util.h>
 #include <version.h>
 #include <watchdog.h>
 #include <clock/ccu.h>
@@ -30,6 +37,14 @@
 
 #define NEXT_STATE (system_state + 2)
 
+#if CONFIG(REGULATOR_RETENTION)
+#define RETENTION_DRAM_MV    CONFIG_REGULATOR_RETENTION_DRAM_MV
+#define RETENTION_VDD_SYS_MV CONFIG_REGULATOR_RETENTION_VDD_SYS_MV
+#else
+#define RETENTION_DRAM_MV    0
+#define RETENTION_VDD_SYS_MV 0
+#endif
+
 /**
  * The enumeration of possible system states.
  *
@@ -63,6 +78,60 @@ enum {
 /* This variable is persisted across exception restarts. */
 static uint8_t system_state = SS_BOOT;
 
+/* Regulators are turned back on in order of increasing dependency. */
+static const struct regulator_handle *const resume_supplies[] = {
+	&vdd_sys_supply,
+	&vcc_pll_supply,
+	&dram_supply,
+	&cpu_supply,
+};
+
+/**
+ * Acquire references to the regulator providers, so the bus and the provider
+ * stay initialized across a whole sequence of regulator operations, instead
+ * of being probed and released around each operation.
+ *
+ * @return A bitmask of the providers that were successfully acquired.
+ */
+static uint32_t
+hold_supplies(void)
+{
+	uint32_t held = 0;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(resume_supplies); ++i) {
+		if (device_get(resume_supplies[i]->dev) == SUCCESS)
+			held |= BIT(i);
+	}
+
+	return held;
+}
+
+/**
+ * Release the references acquired by hold_supplies().
+ *
+ * @param held The bitmask returned by hold_supplies().
+ */
+static void
+release_supplies(uint32_t held)
+{
+	for (uint8_t i = 0; i < ARRAY_SIZE(resume_supplies); ++i) {
+		if (held & BIT(i))
+			device_put(resume_supplies[i]->dev);
+	}
+}
+
+/**
+ * Switch the AR100 clock, keeping serial output intact.
+ */
+static void
+set_cpus_clock(bool boost)
+{
+	serial_flush();
+	ktime_poll();
+	r_ccu_set_cpus_clock(boost);
+	serial_update_rate();
+}
+
 static uint8_t
 select_suspend_depth(uint8_t current_state)
 {
@@ -82,9 +151,17 @@ select_suspend_depth(uint8_t current_state)
 noreturn void
 system_state_machine(uint32_t exception)
 {
-	const struct device *cec, *cir, *mailbox, *pmic, *watchdog;
+	const struct regulator_handle *supplies[ARRAY_SIZE(resume_supplies)];
+	const struct device *cec, *cir, *gpio, *mailbox, *pmic, *watchdog;
 	uint8_t initial_state = system_state;
-	uint8_t suspend_depth;
+	uint8_t nsupplies, suspend_depth;
+	uint64_t start;
+	uint32_t ccu_us UNUSED;
+	uint32_t held_supplies = 0;
+
+	/* Prepare to record log output before anything is logged. */
+	log_buffer_init();
+	energy_init();
 
 	if (initial_state > SS_BOOT) {
 		/*
@@ -95,11 +172,16 @@ system_state_machine(uint32_t exception)
 		 */
 		system_state = SS_OFF;
 
+		/* PLL_PERIPH0 may not survive, so leave it right away. */
+		r_ccu_set_cpus_clock(false);
+
 		/* Clear out inactive references. */
 		cec      = NULL;
 		cir      = NULL;
+		gpio     = NULL;
 		watchdog = NULL;
 		mailbox  = NULL;
+		pmic     = NULL;
 	} else {
 		/* Otherwise, perform BOOT actions and switch to AWAKE. */
 		system_state = SS_AWAKE;
@@ -116,6 +198,7 @@ system_state_machine(uint32_t exception)
 
 		/* Acquire runtime-only devices. */
 		mailbox = device_get_or_null(&msgbox.dev);
+		pmic    = NULL;
 	}
 
 	/*
@@ -149,10 +232,21 @@ system_state_machine(uint32_t exception)
 	}
 
 	for (;;) {
-		debug_print_latency(system_state);
+		ktime_poll();
+		serial_poll();
 
 		switch (system_state) {
 		case SS_AWAKE:
+			debug_record_latency(LATENCY_AWAKE);
+			energy_update(ENERGY_AWAKE);
+
+			/*
+			 * Switch to the fast clock once IOSC is calibrated,
+			 * and follow any later changes to the IOSC rate.
+			 */
+			if (r_ccu_poll())
+				set_cpus_clock(true);
+
 			/* Poll runtime devices. */
 			css_poll();
 			if (watchdog)
@@ -167,6 +261,9 @@ system_state_machine(uint32_t exception)
 		case SS_SUSPEND:
 			debug("Suspending...");
 
+			/* Only this firmware changes clocks until resume. */
+			clock_cache_rates(true);
+
 			/* Synchronize device state with Linux. */
 			record_step(STEP_SUSPEND_DEVICES);
 			simple_device_sync(&pio);
@@ -178,13 +275,25 @@ system_state_machine(uint32_t exception)
 			/* Acquire wakeup sources. */
 			cec = cec_get();
 			cir = cir_get();
+			gpio = sunxi_gpio_wake_get();
 
 			/* Configure the SoC for minimal power consumption. */
 			record_step(STEP_SUSPEND_DRAM);
 			dram_save_checksum();
+			start = ktime_get();
 			dram_suspend();
+			ccu_us = ktime_get() - start;
+
+			/* Write out pending output before changing clocks. */
+			serial_flush();
 			record_step(STEP_SUSPEND_CCU);
+			set_cpus_clock(false);
+			start = ktime_get();
 			ccu_suspend();
+			ccu_us += ktime_get() - start;
+
+			/* Find (and maybe gate) clocks left running. */
+			ccu_gate_audit();
 
 			/*
 			 * Disable watchdog protection. Once devices outside
@@ -198,8 +307,14 @@ system_state_machine(uint32_t exception)
 			suspend_depth = select_suspend_depth(system_state);
 			r_ccu_suspend(suspend_depth);
 
-			/* Perform PMIC-specific actions. */
+			/*
+			 * Perform PMIC-specific actions. The PMIC and the
+			 * regulator providers are often on the same bus. Keep
+			 * them initialized until resume, so the bus is not
+			 * probed again for each operation while asleep.
+			 */
 			record_step(STEP_SUSPEND_PMIC);
+			held_supplies = hold_supplies();
 			if ((pmic = pmic_get())) {
 				if (system_state == SS_SHUTDOWN &&
 				    CONFIG(PMIC_SHUTDOWN))
@@ -210,36 +325,48 @@ system_state_machine(uint32_t exception)
 
 			/* Turn off all unnecessary power domains. */
 			record_step(STEP_SUSPEND_REGULATORS);
-			regulator_disable(&cpu_supply);
+			if (system_state == SS_SUSPEND &&
+			    CONFIG(REGULATOR_RETENTION)) {
+				regulator_enter_retention(&dram_supply,
+				                          RETENTION_DRAM_MV);
+				regulator_enter_retention(&vdd_sys_supply,
+				                          RETENTION_VDD_SYS_MV);
+			}
+			supplies[0] = &cpu_supply, nsupplies = 1;
 			if (system_state == SS_SHUTDOWN) {
-				regulator_disable(&dram_supply);
+				supplies[nsupplies++] = &dram_supply;
 				if (suspend_depth >= SD_OSC24M)
-					regulator_disable(&vcc_pll_supply);
+					supplies[nsupplies++] = &vcc_pll_supply;
 				if (suspend_depth >= SD_VDD_SYS)
-					regulator_disable(&vdd_sys_supply);
+					supplies[nsupplies++] = &vdd_sys_supply;
 			}
-
-			/*
-			 * The regulator provider is often part of the same
-			 * device as the PMIC. Reduce churn by doing both PMIC
-			 * and regulator actions before releasing the PMIC.
-			 */
-			device_put(pmic);
+			regulator_bulk_disable(supplies, nsupplies);
 
 			record_step(STEP_SUSPEND_COMPLETE);
+			debug("CCU suspend took %u us", ccu_us);
 			debug("Suspend to %d complete!", suspend_depth);
 
 			/* The system is now off or asleep. */
+			debug_discard_latency();
 			system_state = NEXT_STATE;
 			break;
 		case SS_OFF:
 		case SS_ASLEEP:
+			debug_record_latency(system_state == SS_OFF ?
+			                     LATENCY_OFF : LATENCY_ASLEEP);
+			energy_update(system_state == SS_OFF ?
+			              ENERGY_OFF : ENERGY_ASLEEP);
 			debug_monitor();
 			debug_print_battery();
 
+			/* Keep R_UART and delays accurate as IOSC drifts. */
+			if (r_ccu_poll())
+				set_cpus_clock(false);
+
 			/* Poll wakeup sources. Reset or resume on wakeup. */
 			if ((cec && cec_poll(cec)) ||
 			    (cir && cir_poll(cir)) ||
+			    (gpio && sunxi_gpio_wake_poll(gpio)) ||
 			    irq_poll())
 				system_state = NEXT_STATE;
 
@@ -252,14 +379,23 @@ system_state_machine(uint32_t exception)
 			 * If it fails, manually turn the regulators back on.
 			 */
 			record_step(STEP_RESUME_PMIC);
-			if (!(pmic = pmic_get()) || pmic_resume(pmic)) {
+			if (!pmic)
+				pmic = pmic_get();
+			if (!pmic || pmic_resume(pmic)) {
 				record_step(STEP_RESUME_REGULATORS);
-				regulator_enable(&vdd_sys_supply);
-				regulator_enable(&vcc_pll_supply);
-				regulator_enable(&dram_supply);
-				regulator_enable(&cpu_supply);
+				/* Enable them in order of dependency. */
+				for (uint8_t i = 0;
+				     i < ARRAY_SIZE(resume_supplies); ++i)
+					regulator_enable(resume_supplies[i]);
+			}
+			if (CONFIG(REGULATOR_RETENTION)) {
+				regulator_exit_retention(&vdd_sys_supply);
+				regulator_exit_retention(&dram_supply);
 			}
-			device_put(pmic);
+
+			/* Release the devices held since suspend. */
+			device_put(pmic), pmic = NULL;
+			release_supplies(held_supplies), held_supplies = 0;
 
 			/* Give regulator outputs time to rise. */
 			udelay(5000);
@@ -279,13 +415,26 @@ system_state_machine(uint32_t exception)
 
 			/* Configure the SoC for full functionality. */
 			record_step(STEP_RESUME_CCU);
+			start = ktime_get();
+			ccu_batch_begin();
+			/* The rich OS may expect these clocks to be running. */
+			ccu_gate_audit_restore();
 			ccu_resume();
+			/*
+			 * Apply the CCU changes, locking its PLLs in parallel,
+			 * before dram_resume() accesses the DRAM controller.
+			 */
+			ccu_batch_commit();
 			record_step(STEP_RESUME_DRAM);
 			dram_resume();
+			ccu_us = ktime_get() - start;
+			debug("CCU resume took %u us", ccu_us);
+			set_cpus_clock(true);
 			dram_verify_checksum();
 
 			/* Release wakeup sources. */
 			record_step(STEP_RESUME_DEVICES);
+			sunxi_gpio_wake_put(gpio), gpio = NULL;
 			device_put(cir), cir = NULL;
 			device_put(cec), cec = NULL;
 
@@ -294,12 +443,14 @@ system_state_machine(uint32_t exception)
 
 			/* Resume execution on the CSS. */
 			record_step(STEP_RESUME_CSS);
+			clock_cache_rates(false);
 			css_resume();
 
 			record_step(STEP_RESUME_COMPLETE);
 			debug("Resume complete!");
 
 			/* The system is now awake. */
+			debug_discard_latency();
 			system_state = SS_AWAKE;
 			break;
 		case SS_REBOOT:
@@ -6,7 +6,6 @@
 #include <counter.h>
 #include <debug.h>
 #include <timeout.h>
-#include <platform/time.h>
 
 bool
 timeout_expired(uint32_t timeout)
@@ -20,8 +19,14 @@ timeout_expired(uint32_t timeout)
 uint32_t
 timeout_set(uint32_t useconds)
 {
-	uint32_t cycles = CPUCLK_MHz * useconds;
-	uint32_t now    = cycle_counter_read();
+	uint32_t khz = cycle_counter_rate_khz();
+	uint32_t now = cycle_counter_read();
+	uint32_t cycles;
+
+	/* Split the product to avoid overflow. Round up the sub-ms part. */
+	assert(useconds / 1000 < UINT32_MAX / khz);
+	cycles  = khz * (useconds / 1000);
+	cycles += (khz * (useconds % 1000) + 999) / 1000;
 
 	/* Ensure the MSB is zero for the wraparound check above. */
 	assert(cycles >> 31 == 0);
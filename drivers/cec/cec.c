@@ -21,3 +21,9 @@ cec_poll(const struct device *dev)
 
 	return dw_hdmi_cec_poll(dev);
 }
+
+int
+cec_set_wake_filter(uint32_t messages, uint32_t initiators)
+{
+	return dw_hdmi_cec_set_wake_filter(messages, initiators);
+}
@@ -6,6 +6,8 @@
 #include <error.h>
 #include <intrusive.h>
 #include <mmio.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <util.h>
 #include <cec/dw-hdmi-cec.h>
 #include <clock/ccu.h>
@@ -33,6 +35,8 @@
 
 #define CEC_CTRL_STANDBY BIT(4)
 
+#define CEC_RX_CNT_MASK  0x1f
+
 #define CEC_LOCK_RELEASE 0x00
 
 /* Set Stream Path */
@@ -57,6 +61,17 @@
 	                  CEC_WKUP_MSG_42 | CEC_WKUP_MSG_41 | \
 	                  CEC_WKUP_MSG_0d | CEC_WKUP_MSG_04)
 
+/* Opcodes of the wakeup messages, in CEC_WKUPCTRL bit order. */
+static const uint8_t dw_hdmi_cec_wake_opcodes[] = {
+	0x04, 0x0d, 0x41, 0x42, 0x44, 0x70, 0x82, 0x86,
+};
+
+/* The filter is kept in .bss, so it falls back to the defaults after an
+ * exception, like the rest of the driver state. */
+static bool     wake_filter_set;
+static uint8_t  wake_messages;
+static uint16_t wake_initiators;
+
 struct dw_hdmi_cec_state {
 	struct device_state ds;
 	uint8_t             stash[4];
@@ -74,6 +89,50 @@ dw_hdmi_cec_state_for(const struct device *dev)
 	return container_of(dev->state, struct dw_hdmi_cec_state, ds);
 }
 
+/**
+ * Check the message in the RX buffer against the wakeup filter.
+ *
+ * The controller only filters by opcode, so the initiator must be checked
+ * here. The opcode is checked again, in case the controller was configured
+ * with a different set of messages.
+ */
+static inline uint8_t
+dw_hdmi_cec_wake_messages(void)
+{
+	return wake_filter_set ? wake_messages : CONFIG_CEC_WAKE_MESSAGES;
+}
+
+static inline uint16_t
+dw_hdmi_cec_wake_initiators(void)
+{
+	return wake_filter_set ? wake_initiators : CONFIG_CEC_WAKE_INITIATORS;
+}
+
+static bool
+dw_hdmi_cec_check_msg(const struct dw_hdmi_cec *self)
+{
+	uint8_t count = mmio_read_8(self->regs + CEC_RX_CNT) & CEC_RX_CNT_MASK;
+	uint8_t header, opcode;
+
+	/* A wakeup message contains at least a header and an opcode. */
+	if (count < 2)
+		return false;
+
+	header = mmio_read_8(self->regs + CEC_RX_DATA);
+	opcode = mmio_read_8(self->regs + CEC_RX_DATA + 1);
+
+	/* The initiator's logical address is in the upper nibble. */
+	if (!(dw_hdmi_cec_wake_initiators() & BIT(header >> 4)))
+		return false;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(dw_hdmi_cec_wake_opcodes); ++i) {
+		if (dw_hdmi_cec_wake_opcodes[i] == opcode)
+			return dw_hdmi_cec_wake_messages() & BIT(i);
+	}
+
+	return false;
+}
+
 uint32_t
 dw_hdmi_cec_poll(const struct device *dev)
 {
@@ -83,7 +142,28 @@ dw_hdmi_cec_poll(const struct device *dev)
 	stat = mmio_read_8(self->regs + CEC_STAT);
 	mmio_write_8(self->regs + CEC_STAT, stat);
 
-	return stat & IRQ_WAKEUP;
+	if (!(stat & IRQ_WAKEUP))
+		return 0;
+	if (dw_hdmi_cec_check_msg(self))
+		return 1;
+
+	/* Drop the message, so the controller can receive the next one. */
+	mmio_write_8(self->regs + CEC_LOCK, CEC_LOCK_RELEASE);
+
+	return 0;
+}
+
+int
+dw_hdmi_cec_set_wake_filter(uint32_t messages, uint32_t initiators)
+{
+	if (messages > UINT8_MAX || initiators > UINT16_MAX)
+		return EINVAL;
+
+	wake_messages   = messages;
+	wake_initiators = initiators;
+	wake_filter_set = true;
+
+	return SUCCESS;
 }
 
 static int
@@ -103,7 +183,8 @@ dw_hdmi_cec_probe(const struct device *dev)
 	mmio_write_8(self->regs + IH_MUTE, IH_MUTE_ALL);
 
 	/* Configure CEC wake up sources */
-	mmio_write_8(self->regs + CEC_WKUPCTRL, CEC_WKUP_MSG_ALL);
+	mmio_write_8(self->regs + CEC_WKUPCTRL,
+	             dw_hdmi_cec_wake_messages());
 
 	/* Allow only wakeup interrupt on posedge */
 	mmio_write_8(self->regs + CEC_POL, IRQ_WAKEUP);
@@ -4,17 +4,238 @@
  */
 
 #include <cir.h>
+#include <counter.h>
+#include <debug.h>
 #include <device.h>
+#include <error.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
 #include <cir/sunxi-cir.h>
 
+#include "cir.h"
+
+#if CONFIG(CIR_PROTO_NEC)
+#define DEFAULT_PROTOCOL CIR_PROTOCOL_NEC
+#elif CONFIG(CIR_PROTO_NECX)
+#define DEFAULT_PROTOCOL CIR_PROTOCOL_NECX
+#elif CONFIG(CIR_PROTO_RC5)
+#define DEFAULT_PROTOCOL CIR_PROTOCOL_RC5
+#elif CONFIG(CIR_PROTO_RC6)
+#define DEFAULT_PROTOCOL CIR_PROTOCOL_RC6
+#elif CONFIG(CIR_PROTO_SIRC)
+#define DEFAULT_PROTOCOL CIR_PROTOCOL_SIRC
+#endif
+
+struct cir_wake_code {
+	uint32_t code;
+	uint8_t  protocol;
+};
+
+static const struct cir_decoder cir_decoders[] = {
+#if CONFIG(CIR_DECODER_NEC)
+	{ cir_decode_nec, CIR_PROTOCOL_NEC },
+#endif
+#if CONFIG(CIR_DECODER_NECX)
+	{ cir_decode_necx, CIR_PROTOCOL_NECX },
+#endif
+#if CONFIG(CIR_DECODER_RC5)
+	{ cir_decode_rc5, CIR_PROTOCOL_RC5 },
+#endif
+#if CONFIG(CIR_DECODER_RC6)
+	{ cir_decode_rc6, CIR_PROTOCOL_RC6 },
+#endif
+#if CONFIG(CIR_DECODER_SIRC)
+	{ cir_decode_sirc, CIR_PROTOCOL_SIRC, cir_finish_sirc },
+#endif
+};
+
+/* Every decoder sees every sample, so each needs its own context. */
+static struct cir_dec_ctx cir_contexts[ARRAY_SIZE(cir_decoders)];
+
+/* Wakeup scan codes as set by the rich OS, in no particular order. */
+static struct cir_wake_code wake_slots[CIR_MAX_WAKE_CODES];
+
+/* Wakeup scan codes used while polling, sorted by code. */
+static struct cir_wake_code wake_codes[CIR_MAX_WAKE_CODES];
+static uint8_t wake_count;
+
+/* Decoder steps taken during the current poll, if tracing is enabled. */
+static uint32_t cir_steps;
+
+/**
+ * Insert a scan code into the sorted table used while polling.
+ */
+static void
+cir_add_wake_code(const struct cir_wake_code *entry)
+{
+	uint8_t i = wake_count++;
+
+	while (i > 0 && wake_codes[i - 1].code > entry->code) {
+		wake_codes[i] = wake_codes[i - 1];
+		--i;
+	}
+	wake_codes[i] = *entry;
+}
+
+/**
+ * Check if a decoded scan code is in the wakeup table.
+ */
+static bool
+cir_match(uint8_t protocol, uint32_t code)
+{
+	uint8_t lo = 0, hi = wake_count;
+
+	/* Find the first entry with a code greater than or equal. */
+	while (lo < hi) {
+		uint8_t mid = (lo + hi) / 2;
+
+		if (wake_codes[mid].code < code)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	/* Several protocols could use the same code. */
+	for (; lo < wake_count && wake_codes[lo].code == code; ++lo) {
+		if (wake_codes[lo].protocol == protocol)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Reset a decoder context, discarding any partial frame.
+ */
+static void
+cir_reset_ctx(struct cir_dec_ctx *ctx)
+{
+	ctx->buffer  = 0;
+	ctx->counter = 0;
+	ctx->bits    = 0;
+	ctx->state   = 0;
+	ctx->width   = 0;
+}
+
 const struct device *
 cir_get(void)
 {
+	static const struct cir_wake_code default_code = {
+		.code     = CONFIG_CIR_WAKE_CODE,
+		.protocol = DEFAULT_PROTOCOL,
+	};
+
+	/* Build the lookup table from the current settings. */
+	wake_count = 0;
+	for (uint8_t i = 0; i < ARRAY_SIZE(wake_slots); ++i) {
+		if (wake_slots[i].code)
+			cir_add_wake_code(&wake_slots[i]);
+	}
+	if (!wake_count)
+		cir_add_wake_code(&default_code);
+
+	/* Start decoding from a clean state. */
+	for (uint8_t i = 0; i < ARRAY_SIZE(cir_contexts); ++i)
+		cir_reset_ctx(&cir_contexts[i]);
+
 	return device_get_or_null(&r_cir_rx.dev);
 }
 
+/**
+ * Run every decoder over a whole sample.
+ *
+ * @return Nonzero if a wakeup scan code was decoded, else zero.
+ */
+static uint32_t
+cir_feed(uint8_t sample)
+{
+	uint32_t wake = 0;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(cir_decoders); ++i) {
+		const struct cir_decoder *decoder = &cir_decoders[i];
+		struct cir_dec_ctx *ctx = &cir_contexts[i];
+
+		ctx->pulse = sample >> 7;
+		ctx->width = sample & GENMASK(6, 0);
+		while (ctx->width > 0) {
+			uint32_t code = decoder->decode(ctx);
+
+			if (CONFIG(DEBUG_TRACE_CIR))
+				++cir_steps;
+			if (code && cir_match(decoder->protocol, code))
+				wake = 1;
+		}
+	}
+
+	return wake;
+}
+
+/**
+ * Let every decoder finish its frame once the receiver goes idle, and start
+ * the next packet from a clean state.
+ *
+ * @return Nonzero if a wakeup scan code was decoded, else zero.
+ */
+static uint32_t
+cir_idle(void)
+{
+	uint32_t wake = 0;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(cir_decoders); ++i) {
+		const struct cir_decoder *decoder = &cir_decoders[i];
+		struct cir_dec_ctx *ctx = &cir_contexts[i];
+
+		if (decoder->finish) {
+			uint32_t code = decoder->finish(ctx);
+
+			if (code && cir_match(decoder->protocol, code))
+				wake = 1;
+		}
+		cir_reset_ctx(ctx);
+	}
+
+	return wake;
+}
+
 uint32_t
 cir_poll(const struct device *dev)
 {
-	return sunxi_cir_poll(dev) == CONFIG_CIR_WAKE_CODE;
+	uint8_t  samples[SUNXI_CIR_FIFO_SIZE];
+	uint32_t wake = 0;
+	uint32_t start;
+	uint8_t  count;
+	bool     idle;
+
+	count = sunxi_cir_poll(dev, samples, &idle);
+	cir_steps = 0;
+	start     = CONFIG(DEBUG_TRACE_CIR) ? cycle_counter_read() : 0;
+	for (uint8_t i = 0; i < count; ++i)
+		wake |= cir_feed(samples[i]);
+	/*
+	 * Dividing the cycles by the steps gives the cost of a decoder step,
+	 * which tools/cirbench uses to estimate the load for a given remote.
+	 */
+	if (CONFIG(DEBUG_TRACE_CIR) && count) {
+		debug("CIR: %u samples, %u steps, %u cycles",
+		      count, cir_steps, cycle_counter_read() - start);
+	}
+	if (idle)
+		wake |= cir_idle();
+
+	return wake;
+}
+
+int
+cir_set_wake_code(uint8_t index, uint8_t protocol, uint32_t code)
+{
+	if (index >= ARRAY_SIZE(wake_slots))
+		return ERANGE;
+	if (protocol >= CIR_PROTOCOLS)
+		return EINVAL;
+
+	wake_slots[index].code     = code;
+	wake_slots[index].protocol = protocol;
+
+	return SUCCESS;
 }
@@ -8,6 +8,10 @@
 
 #include <stdint.h>
 
+/* Check if a pulse width is within a margin of the expected width. */
+#define EQ_MARGIN(val, time, margin) \
+	(((time) - (margin)) < (val) && (val) < ((time) + (margin)))
+
 /**
  * Possible values for pulse type.
  */
@@ -29,16 +33,34 @@ struct cir_dec_ctx {
 };
 
 /**
- * Decode a CIR pulse sequence.
+ * A CIR protocol decoder.
  *
- * The pulse flag and width must be valid each time this function is called.
- * Each call will decode a single pulse, so decoding a complete scancode
- * requires many calls. All but the last in the sequence will return zero.
+ * The pulse flag and width must be valid each time the decode function is
+ * called. Each call will decode a single pulse, so decoding a complete
+ * scancode requires many calls. All but the last in the sequence will return
+ * zero. Each call consumes some or all of the width; the caller must call
+ * the function again until the width is used up.
  *
  * If an error occurs, decoding restarts, but the error is not reported.
  *
- * @return A successfully decoded scancode, or zero.
+ * The decode function returns a successfully decoded scancode, or zero.
+ *
+ * The optional finish function is called when the receiver goes idle. It
+ * completes a frame that can only be recognized by its trailing space, and
+ * returns the scancode, or zero.
  */
-uint32_t cir_decode(struct cir_dec_ctx *ctx);
+struct cir_decoder {
+	uint32_t (*decode)(struct cir_dec_ctx *ctx);
+	uint8_t  protocol;
+	uint32_t (*finish)(struct cir_dec_ctx *ctx);
+};
+
+uint32_t cir_decode_nec(struct cir_dec_ctx *ctx);
+uint32_t cir_decode_necx(struct cir_dec_ctx *ctx);
+uint32_t cir_decode_rc5(struct cir_dec_ctx *ctx);
+uint32_t cir_decode_rc6(struct cir_dec_ctx *ctx);
+uint32_t cir_decode_sirc(struct cir_dec_ctx *ctx);
+
+uint32_t cir_finish_sirc(struct cir_dec_ctx *ctx);
 
 #endif /* CIR_PRIVATE_H */
@@ -10,9 +10,6 @@
 
 #include "cir.h"
 
-#define EQ_MARGIN(val, time, margin) \
-	(((time) - (margin)) < (val) && (val) < ((time) + (margin)))
-
 #define NUM_DATA_BITS 32
 
 /* NEC time unit is ~562.5 us, or ~1777 units/s. */
@@ -47,8 +44,13 @@ static const uint8_t nec_pulse_states[NEC_STATES] = {
 	[NEC_DATA]   = CIR_SPACE,
 };
 
-uint32_t
-cir_decode(struct cir_dec_ctx *ctx)
+/**
+ * Decode a NEC pulse sequence.
+ *
+ * @return The raw 32-bit frame, in transmission order, or zero.
+ */
+static uint32_t
+nec_decode(struct cir_dec_ctx *ctx)
 {
 	uint32_t counter = ctx->counter;
 	uint32_t ret     = 0;
@@ -83,20 +85,10 @@ cir_decode(struct cir_dec_ctx *ctx)
 		ctx->state = NEC_IDLE;
 		if (!EQ_MARGIN(counter, NEC_DATA_M, NEC_HALF_MARGIN))
 			break;
-		if (ctx->bits == NUM_DATA_BITS) {
-			/* Would be nice to check if inverted values match. */
-			if (CONFIG(CIR_PROTO_NECX)) {
-				ret = ((ctx->buffer << 16) & GENMASK(23, 16)) |
-				      (ctx->buffer & GENMASK(15, 8)) |
-				      ((ctx->buffer >> 16) & GENMASK(7, 0));
-			} else {
-				ret = ((ctx->buffer << 8) & GENMASK(15, 8)) |
-				      ((ctx->buffer >> 16) & GENMASK(7, 0));
-			}
-			debug("NEC code %06x", ret);
-		} else {
+		if (ctx->bits == NUM_DATA_BITS)
+			ret = ctx->buffer;
+		else
 			ctx->state = NEC_DATA;
-		}
 		break;
 	case NEC_DATA:
 		/* NEC is LSB first. */
@@ -114,3 +106,45 @@ cir_decode(struct cir_dec_ctx *ctx)
 
 	return ret;
 }
+
+#if CONFIG(CIR_DECODER_NEC)
+
+uint32_t
+cir_decode_nec(struct cir_dec_ctx *ctx)
+{
+	uint32_t raw = nec_decode(ctx);
+	uint32_t ret;
+
+	if (!raw)
+		return 0;
+
+	/* Would be nice to check if inverted values match. */
+	ret = ((raw << 8) & GENMASK(15, 8)) |
+	      ((raw >> 16) & GENMASK(7, 0));
+	debug("NEC code %06x", ret);
+
+	return ret;
+}
+
+#endif
+
+#if CONFIG(CIR_DECODER_NECX)
+
+uint32_t
+cir_decode_necx(struct cir_dec_ctx *ctx)
+{
+	uint32_t raw = nec_decode(ctx);
+	uint32_t ret;
+
+	if (!raw)
+		return 0;
+
+	ret = ((raw << 16) & GENMASK(23, 16)) |
+	      (raw & GENMASK(15, 8)) |
+	      ((raw >> 16) & GENMASK(7, 0));
+	debug("NECX code %06x", ret);
+
+	return ret;
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <debug.h>
+#include <division.h>
+#include <stdint.h>
+#include <util.h>
+
+#include "cir.h"
+
+#define RC5_DATA_BITS        13
+
+/* RC5 time unit is 32 periods @ 36 kHz, ~889 us. */
+#define RC5_CARRIER_FREQ     36000
+#define RC5_UNIT_RATE        (RC5_CARRIER_FREQ / 32)
+
+/* Convert specified number of time units to number of clock cycles. */
+#define RC5_UNITS_TO_CLKS(num) \
+	UDIV_ROUND((num) * CONFIG_CIR_CLK_RATE, RC5_UNIT_RATE)
+
+/* Bit positions in the buffer after the last bit is received. */
+#define RC5_FIELD_BIT        12
+#define RC5_ADDRESS(buffer)  (((buffer) >> 6) & GENMASK(4, 0))
+#define RC5_COMMAND(buffer)  ((buffer) & GENMASK(5, 0))
+
+enum {
+	RC5_IDLE,
+	RC5_DATA_P,
+	RC5_DATA_N,
+	RC5_STATES
+};
+
+uint32_t
+cir_decode_rc5(struct cir_dec_ctx *ctx)
+{
+	int32_t duration = RC5_UNITS_TO_CLKS(1);
+	int32_t epsilon  = RC5_UNITS_TO_CLKS(1) / 2;
+
+	/* Subtract the expected pulse width from the sample width. */
+	ctx->width -= duration;
+
+	/* A short pulse means noise or a lost sync. Restart the decoder. */
+	if (ctx->width < -epsilon) {
+		ctx->state = RC5_IDLE;
+		return 0;
+	}
+
+	/* Discard the remainder of the sample if less than epsilon remains. */
+	if (ctx->width <= epsilon)
+		ctx->width = 0;
+
+	switch (ctx->state) {
+	case RC5_IDLE:
+		/*
+		 * The first half of the first start bit cannot be told apart
+		 * from the idle space, so the frame begins with its second
+		 * half, which is a mark.
+		 */
+		if (!ctx->pulse)
+			break;
+		ctx->bits   = RC5_DATA_BITS;
+		ctx->buffer = 1;
+		ctx->state  = RC5_DATA_P;
+		break;
+	case RC5_DATA_P:
+		/* A one is encoded as a space followed by a mark. */
+		ctx->buffer = ctx->buffer << 1 | !ctx->pulse;
+		ctx->state  = RC5_DATA_N;
+		break;
+	case RC5_DATA_N:
+		ctx->state = RC5_IDLE;
+		/* This pulse must negate the previous pulse. */
+		if (ctx->pulse != (ctx->buffer & 1))
+			break;
+		if (--ctx->bits == 0) {
+			uint32_t buffer = ctx->buffer;
+			uint32_t code;
+
+			/* Drop the toggle bit. An inverted field bit extends
+			 * the command to 7 bits (RC5X). */
+			code = RC5_ADDRESS(buffer) << 8 |
+			       RC5_COMMAND(buffer) |
+			       (buffer & BIT(RC5_FIELD_BIT) ? 0 : BIT(6));
+			debug("RC5 code %04x", code);
+			return code;
+		}
+		ctx->state = RC5_DATA_P;
+		break;
+	default:
+		unreachable();
+	}
+
+	return 0;
+}
@@ -51,7 +51,7 @@ static const int16_t rc6_durations[RC6_STATES] = {
 };
 
 uint32_t
-cir_decode(struct cir_dec_ctx *ctx)
+cir_decode_rc6(struct cir_dec_ctx *ctx)
 {
 	int32_t duration = rc6_durations[ctx->state];
 	int32_t epsilon  = ctx->state == RC6_IDLE ?
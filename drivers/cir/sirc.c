@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <debug.h>
+#include <division.h>
+#include <stdint.h>
+#include <util.h>
+
+#include "cir.h"
+
+#define MAX_DATA_BITS      20
+
+/* SIRC time unit is 600 us, or ~1667 units/s. */
+#define SIRC_UNIT_RATE     1667
+
+/* Convert specified number of time units to number of clock cycles. */
+#define SIRC_UNITS_TO_CLKS(num) \
+	UDIV_ROUND((num) * CONFIG_CIR_CLK_RATE, SIRC_UNIT_RATE)
+
+#define SIRC_LEAD_M        SIRC_UNITS_TO_CLKS(4)
+#define SIRC_DATA_S        SIRC_UNITS_TO_CLKS(1)
+#define SIRC_DATA_M_0      SIRC_UNITS_TO_CLKS(1)
+#define SIRC_DATA_M_1      SIRC_UNITS_TO_CLKS(2)
+
+#define SIRC_HALF_MARGIN   (SIRC_UNITS_TO_CLKS(1) / 2)
+#define SIRC_SINGLE_MARGIN SIRC_UNITS_TO_CLKS(1)
+
+enum {
+	SIRC_IDLE,
+	SIRC_SPACE,
+	SIRC_DATA,
+	SIRC_STATES
+};
+
+static const uint8_t sirc_pulse_states[SIRC_STATES] = {
+	[SIRC_IDLE]  = CIR_MARK,
+	[SIRC_SPACE] = CIR_SPACE,
+	[SIRC_DATA]  = CIR_MARK,
+};
+
+/**
+ * Convert a complete frame to a scancode. Every frame starts with a 7-bit
+ * command, followed by a 5-bit or 8-bit device, and an optional 8-bit
+ * extended device.
+ */
+static uint32_t
+sirc_scancode(uint32_t buffer, uint8_t bits)
+{
+	uint32_t command = buffer & GENMASK(6, 0);
+
+	switch (bits) {
+	case 12:
+		return (buffer >> 7 & GENMASK(4, 0)) << 16 | command;
+	case 15:
+		return (buffer >> 7 & GENMASK(7, 0)) << 16 | command;
+	case 20:
+		return (buffer >> 7 & GENMASK(4, 0)) << 16 |
+		       (buffer >> 12 & GENMASK(7, 0)) << 8 | command;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * End the frame in progress, and report it if it has a valid length.
+ */
+static uint32_t
+sirc_end_frame(struct cir_dec_ctx *ctx)
+{
+	uint32_t ret = sirc_scancode(ctx->buffer, ctx->bits);
+
+	ctx->state = SIRC_IDLE;
+	if (ret)
+		debug("SIRC code %06x", ret);
+
+	return ret;
+}
+
+uint32_t
+cir_decode_sirc(struct cir_dec_ctx *ctx)
+{
+	uint32_t counter = ctx->counter;
+	uint32_t ret     = 0;
+
+	/* Consume samples until the pulse state changes. */
+	if (sirc_pulse_states[ctx->state] == ctx->pulse) {
+		ctx->counter += ctx->width;
+		ctx->width    = 0;
+		return 0;
+	}
+
+	/* Then reinitialize the cumulative counter for the next state. */
+	ctx->counter = 0;
+
+	switch (ctx->state) {
+	case SIRC_IDLE:
+		if (EQ_MARGIN(counter, SIRC_LEAD_M, SIRC_SINGLE_MARGIN)) {
+			ctx->bits   = 0;
+			ctx->buffer = 0;
+			ctx->state  = SIRC_SPACE;
+		} else {
+			ctx->width = 0;
+		}
+		break;
+	case SIRC_SPACE:
+		if (EQ_MARGIN(counter, SIRC_DATA_S, SIRC_HALF_MARGIN)) {
+			ctx->state = SIRC_DATA;
+			break;
+		}
+		/*
+		 * The frame length is only known once the space after the
+		 * last bit is longer than a bit space.
+		 */
+		if (counter > SIRC_DATA_S)
+			ret = sirc_end_frame(ctx);
+		else
+			ctx->state = SIRC_IDLE;
+		break;
+	case SIRC_DATA:
+		/* SIRC is LSB first. */
+		ctx->state = SIRC_SPACE;
+		if (EQ_MARGIN(counter, SIRC_DATA_M_1, SIRC_HALF_MARGIN))
+			ctx->buffer |= BIT(ctx->bits);
+		else if (!EQ_MARGIN(counter, SIRC_DATA_M_0, SIRC_HALF_MARGIN))
+			ctx->state = SIRC_IDLE;
+		if (++ctx->bits > MAX_DATA_BITS)
+			ctx->state = SIRC_IDLE;
+		break;
+	default:
+		unreachable();
+	}
+
+	return ret;
+}
+
+uint32_t
+cir_finish_sirc(struct cir_dec_ctx *ctx)
+{
+	/* The receiver only goes idle after a space much longer than a bit
+	 * space, so a frame waiting for its next bit is complete. */
+	if (ctx->state != SIRC_SPACE)
+		return 0;
+
+	return sirc_end_frame(ctx);
+}
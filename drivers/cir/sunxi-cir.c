@@ -3,8 +3,11 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <debug.h>
 #include <error.h>
 #include <mmio.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <util.h>
 #include <cir/sunxi-cir.h>
 #include <clock/ccu.h>
@@ -12,8 +15,6 @@
 #include <platform/devices.h>
 #include <platform/prcm.h>
 
-#include "cir.h"
-
 #define CIR_RXCTL  0x00
 #define CIR_RXPCFG 0x10
 #define CIR_RXFIFO 0x20
@@ -21,10 +22,24 @@
 #define CIR_RXSTA  0x30
 #define CIR_RXCFG  0x34
 
+#define CIR_RXINT_ROI_EN   BIT(0)
+#define CIR_RXINT_RPEI_EN  BIT(1)
+#define CIR_RXINT_RAI_EN   BIT(4)
+#define CIR_RXINT_RAL(n)   ((n) << 8)
+
+#define CIR_RXSTA_ROI      BIT(0)
+#define CIR_RXSTA_RPE      BIT(1)
+#define CIR_RXSTA_RA       BIT(4)
+#define CIR_RXSTA_RAC(sta) (((sta) >> 8) & GENMASK(6, 0))
+#define CIR_RXSTA_EVENTS   (CIR_RXSTA_ROI | CIR_RXSTA_RPE | CIR_RXSTA_RA)
+
+/* Signal the main loop once the FIFO is half full. */
+#define CIR_RX_LEVEL       (SUNXI_CIR_FIFO_SIZE / 2)
+
 struct sunxi_cir_state {
 	struct device_state ds;
-	struct cir_dec_ctx  dec_ctx;
 	uint32_t            clk_stash;
+	uint32_t            overruns;
 };
 
 static inline const struct sunxi_cir *
@@ -39,25 +54,34 @@ sunxi_cir_state_for(const struct device *dev)
 	return container_of(dev->state, struct sunxi_cir_state, ds);
 }
 
-uint32_t
-sunxi_cir_poll(const struct device *dev)
+uint8_t
+sunxi_cir_poll(const struct device *dev, uint8_t *samples, bool *idle)
 {
 	const struct sunxi_cir *self  = to_sunxi_cir(dev);
 	struct sunxi_cir_state *state = sunxi_cir_state_for(dev);
-	struct cir_dec_ctx *dec_ctx   = &state->dec_ctx;
+	uint32_t status = mmio_read_32(self->regs + CIR_RXSTA);
+	uint8_t  count;
 
-	/* Feed the decoder data as needed and as it becomes available. */
-	if (dec_ctx->width <= 0) {
-		/* If no data is available, do not call the decoder. */
-		if (!(mmio_read_32(self->regs + CIR_RXSTA) >> 8))
-			return 0;
+	/* A packet ends once the input stays idle for the idle threshold. */
+	*idle = status & CIR_RXSTA_RPE;
 
-		uint32_t sample = mmio_read_32(self->regs + CIR_RXFIFO);
-		dec_ctx->pulse = sample >> 7;
-		dec_ctx->width = sample & GENMASK(6, 0);
-	}
+	/* Wait until the FIFO reaches the threshold or a packet ends. */
+	if (!(status & CIR_RXSTA_EVENTS))
+		return 0;
 
-	return cir_decode(dec_ctx);
+	/* Acknowledge the events before draining the FIFO, so samples
+	 * arriving in the meantime raise a new event. */
+	mmio_write_32(self->regs + CIR_RXSTA, status & CIR_RXSTA_EVENTS);
+	if (status & CIR_RXSTA_ROI)
+		state->overruns++;
+
+	count = CIR_RXSTA_RAC(status);
+	if (count > SUNXI_CIR_FIFO_SIZE)
+		count = SUNXI_CIR_FIFO_SIZE;
+	for (uint8_t i = 0; i < count; ++i)
+		samples[i] = mmio_read_32(self->regs + CIR_RXFIFO);
+
+	return count;
 }
 
 static int
@@ -81,6 +105,13 @@ sunxi_cir_probe(const struct device *dev)
 	mmio_write_32(self->regs + CIR_RXCFG,
 	              CONFIG(CIR_USE_OSC24M) ? 0x00001404 : 0x010f0310);
 
+	/* Flag FIFO level, packet end, and overrun events. */
+	mmio_write_32(self->regs + CIR_RXINT,
+	              CIR_RXINT_RAL(CIR_RX_LEVEL - 1) | CIR_RXINT_RAI_EN |
+	              CIR_RXINT_RPEI_EN | CIR_RXINT_ROI_EN);
+	mmio_write_32(self->regs + CIR_RXSTA, CIR_RXSTA_EVENTS);
+	state->overruns = 0;
+
 	/* Enable CIR module. */
 	mmio_write_32(self->regs + CIR_RXCTL, 0x33);
 
@@ -93,6 +124,10 @@ sunxi_cir_release(const struct device *dev)
 	const struct sunxi_cir *self  = to_sunxi_cir(dev);
 	struct sunxi_cir_state *state = sunxi_cir_state_for(dev);
 
+	if (state->overruns)
+		debug("%s: %u FIFO overruns", dev->name, state->overruns);
+
+	mmio_write_32(self->regs + CIR_RXINT, 0);
 	clock_put(&self->mod_clock);
 	clock_put(&self->bus_clock);
 	mmio_write_32(R_CIR_RX_CLK_REG, state->clk_stash);
@@ -5,20 +5,178 @@
 
 #include <bitmap.h>
 #include <clock.h>
+#include <debug.h>
 #include <device.h>
 #include <error.h>
 #include <intrusive.h>
+#include <mmio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
 #include <clock/ccu.h>
 
 #include "ccu.h"
 
+#define CCU_BATCH_REGS  8
+#define CCU_BATCH_LOCKS 4
+
+/**
+ * A pending change to a CCU register, or a pending wait for a lock bit.
+ */
+struct ccu_batch_entry {
+	uintptr_t addr;
+	uint32_t  set;
+	uint32_t  clr;
+};
+
+static struct ccu_batch_entry batch_regs[CCU_BATCH_REGS];
+static struct ccu_batch_entry batch_locks[CCU_BATCH_LOCKS];
+static uint8_t batch_depth, batch_nregs, batch_nlocks;
+
 static inline const struct ccu *
 to_ccu(const struct device *dev)
 {
 	return container_of(dev, const struct ccu, dev);
 }
 
+/**
+ * Find the pending change to a register, if there is one.
+ */
+static struct ccu_batch_entry *
+ccu_batch_find(uintptr_t addr)
+{
+	for (uint8_t i = 0; i < batch_nregs; ++i) {
+		if (batch_regs[i].addr == addr)
+			return &batch_regs[i];
+	}
+
+	return NULL;
+}
+
+/**
+ * Check if a pending change enables a PLL, by looking for a lock wait on the
+ * same register.
+ */
+static bool
+ccu_batch_is_pll(uintptr_t addr)
+{
+	for (uint8_t i = 0; i < batch_nlocks; ++i) {
+		if (batch_locks[i].addr == addr)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Set or clear bits in a register, or queue the change if a batch is open.
+ * Changes to the same register are merged, and registers are written in the
+ * order they were first changed, except that PLLs are enabled first.
+ */
+static void
+ccu_write_bits(uintptr_t addr, uint32_t mask, bool set)
+{
+	struct ccu_batch_entry *entry;
+
+	if (!batch_depth) {
+		(set ? mmio_set_32 : mmio_clr_32)(addr, mask);
+		return;
+	}
+
+	if (!(entry = ccu_batch_find(addr))) {
+		if (batch_nregs == CCU_BATCH_REGS)
+			ccu_batch_flush();
+		entry       = &batch_regs[batch_nregs++];
+		entry->addr = addr;
+		entry->set  = 0;
+		entry->clr  = 0;
+	}
+	if (set) {
+		entry->set |= mask;
+		entry->clr &= ~mask;
+	} else {
+		entry->set &= ~mask;
+		entry->clr |= mask;
+	}
+}
+
+/**
+ * Wait for a lock bit to be set, or queue the wait if a batch is open.
+ */
+static void
+ccu_wait_lock(uintptr_t addr, uint32_t mask)
+{
+	if (!batch_depth) {
+		mmio_poll_32(addr, mask);
+		return;
+	}
+
+	if (batch_nlocks == CCU_BATCH_LOCKS)
+		ccu_batch_flush();
+	batch_locks[batch_nlocks].addr  = addr;
+	batch_locks[batch_nlocks].set   = mask;
+	batch_nlocks++;
+}
+
+/**
+ * Get a gate or reset bit, including any pending change to it.
+ */
+static bool
+ccu_get_bit(uintptr_t regs, uint32_t index)
+{
+	uintptr_t addr = regs + BITMAP_WORD(index);
+	uint32_t mask  = BIT(BITMAP_BIT(index));
+	struct ccu_batch_entry *entry;
+
+	if ((entry = ccu_batch_find(addr))) {
+		if (entry->set & mask)
+			return true;
+		if (entry->clr & mask)
+			return false;
+	}
+
+	return mmio_get_32(addr, mask);
+}
+
+void
+ccu_batch_begin(void)
+{
+	++batch_depth;
+}
+
+void
+ccu_batch_commit(void)
+{
+	ccu_batch_flush();
+	--batch_depth;
+}
+
+void
+ccu_batch_flush(void)
+{
+	/* Enable every PLL before waiting for any of them to lock. */
+	for (uint8_t i = 0; i < batch_nregs; ++i) {
+		if (!ccu_batch_is_pll(batch_regs[i].addr))
+			continue;
+		mmio_clrset_32(batch_regs[i].addr, batch_regs[i].clr,
+		               batch_regs[i].set);
+	}
+	for (uint8_t i = 0; i < batch_nlocks; ++i)
+		mmio_poll_32(batch_locks[i].addr, batch_locks[i].set);
+	/* Only change resets, gates, and update bits once PLLs are stable. */
+	for (uint8_t i = 0; i < batch_nregs; ++i) {
+		if (ccu_batch_is_pll(batch_regs[i].addr))
+			continue;
+		mmio_clrset_32(batch_regs[i].addr, batch_regs[i].clr,
+		               batch_regs[i].set);
+	}
+	if (batch_nregs)
+		clock_invalidate_rates();
+
+	batch_nregs  = 0;
+	batch_nlocks = 0;
+}
+
 const struct clock_handle *
 ccu_get_null_parent(const struct ccu *self UNUSED,
                     const struct ccu_clock *clk UNUSED)
@@ -60,10 +218,10 @@ ccu_get_state(const struct clock_handle *clock)
 	uintptr_t regs = self->regs;
 
 	/* Check the reset line, if present. */
-	if (clk->reset && !bitmap_get(regs, clk->reset))
+	if (clk->reset && !ccu_get_bit(regs, clk->reset))
 		return CLOCK_STATE_DISABLED;
 	/* Check the clock gate, if present. */
-	if (clk->gate && !bitmap_get(regs, clk->gate))
+	if (clk->gate && !ccu_get_bit(regs, clk->gate))
 		return CLOCK_STATE_GATED;
 
 	/* Otherwise, the clock is enabled. */
@@ -84,19 +242,99 @@ ccu_set_state(const struct clock_handle *clock, uint32_t state)
 		return;
 
 	/* First, (de)assert the reset line. */
-	if (clk->reset)
-		(enable ? bitmap_set : bitmap_clear)(regs, clk->reset);
+	if (clk->reset) {
+		ccu_write_bits(regs + BITMAP_WORD(clk->reset),
+		               BIT(BITMAP_BIT(clk->reset)), enable);
+	}
 	/* Once the device is in/out of reset, (un)gate the clock. */
-	if (clk->gate)
-		(ungate ? bitmap_set : bitmap_clear)(regs, clk->gate);
+	if (clk->gate) {
+		ccu_write_bits(regs + BITMAP_WORD(clk->gate),
+		               BIT(BITMAP_BIT(clk->gate)), ungate);
+	}
 	/* Apply the changes by setting the update bit, if applicable. */
 	if (clk->update)
-		mmio_set_32(regs + clk->reg, BIT(clk->update));
+		ccu_write_bits(regs + clk->reg, BIT(clk->update), true);
 	/* Wait for the lock bit to be set, if applicable. */
 	if (clk->lock && ungate)
-		mmio_poll_32(regs + clk->reg, BIT(clk->lock));
+		ccu_wait_lock(regs + clk->reg, BIT(clk->lock));
+
+	/* Updating the clock may apply a new parent or divider. */
+	if (!batch_depth)
+		clock_invalidate_rates();
 }
 
+#if CONFIG(CCU_GATE_AUDIT)
+
+/* Gates closed by ccu_gate_audit(), for each gate register. */
+static uint32_t audit_gated[CCU_GATE_REGS_MAX];
+
+/**
+ * Get the gates in a register that belong to clocks the firmware is using.
+ */
+static uint32_t
+ccu_gates_in_use(uint16_t reg)
+{
+	uint32_t in_use = 0;
+
+	for (uint8_t id = 0; id < ccu.nclocks; ++id) {
+		const struct clock_handle clock = { .dev = &ccu.dev, .id = id };
+		const struct ccu_clock *clk = &ccu.clocks[id];
+
+		if (clk->gate && BITMAP_WORD(clk->gate) == reg &&
+		    clock_active(&clock))
+			in_use |= BIT(BITMAP_BIT(clk->gate));
+	}
+
+	return in_use;
+}
+
+uint32_t
+ccu_gate_audit(void)
+{
+	uint32_t running = 0;
+
+	for (uint8_t i = 0; i < ccu_ngate_regs; ++i) {
+		const struct ccu_gate_reg *gate_reg = &ccu_gate_regs[i];
+		uintptr_t addr = ccu.regs + gate_reg->reg;
+		uint32_t open;
+
+		open = mmio_read_32(addr) & gate_reg->gates &
+		       ~ccu_gates_in_use(gate_reg->reg);
+		for (uint8_t bit = 0; bit < 32; ++bit) {
+			if (!(open & BIT(bit)))
+				continue;
+			++running;
+			debug("%s: Gate 0x%03x:%u left running",
+			      ccu.dev.name, gate_reg->reg, bit);
+		}
+		if (!CONFIG(CCU_GATE_AUDIT_FORCE))
+			continue;
+
+		audit_gated[i] = open & ~gate_reg->keep;
+		if (audit_gated[i])
+			ccu_write_bits(addr, audit_gated[i], false);
+	}
+	if (running)
+		info("%s: %u clocks left running", ccu.dev.name, running);
+
+	return running;
+}
+
+void
+ccu_gate_audit_restore(void)
+{
+	for (uint8_t i = 0; i < ccu_ngate_regs; ++i) {
+		if (!audit_gated[i])
+			continue;
+
+		ccu_write_bits(ccu.regs + ccu_gate_regs[i].reg,
+		               audit_gated[i], true);
+		audit_gated[i] = 0;
+	}
+}
+
+#endif
+
 const struct clock_driver ccu_driver = {
 	.drv = {
 		.probe   = dummy_probe,
@@ -51,6 +51,18 @@ struct ccu_clock {
 	uint16_t reset;
 };
 
+/* The largest number of gate registers checked by ccu_gate_audit(). */
+#define CCU_GATE_REGS_MAX 40
+
+struct ccu_gate_reg {
+	/** Byte offset of the register. */
+	uint16_t reg;
+	/** Mask of the bus clock gates in the register. */
+	uint32_t gates;
+	/** Mask of the gates that must keep running while asleep. */
+	uint32_t keep;
+};
+
 /*
  * ccu.c
  * =====
@@ -70,6 +82,15 @@ const struct clock_handle *ccu_get_null_parent(const struct ccu *self,
 uint32_t ccu_get_parent_rate(const struct ccu *self,
                              const struct ccu_clock *clk, uint32_t rate);
 
+/*
+ * SoC-specific CCU drivers
+ * ========================
+ */
+
+/** Bus clock gate registers in the main CCU, checked by ccu_gate_audit(). */
+extern const struct ccu_gate_reg ccu_gate_regs[];
+extern const uint8_t ccu_ngate_regs;
+
 /*
  * ccu_helpers.c
  * =============
@@ -95,6 +116,7 @@ uint32_t r_ccu_common_get_iosc_rate(const struct ccu *self,
                                     const struct ccu_clock *clk,
                                     uint32_t rate);
 void r_ccu_common_suspend(uint8_t depth);
+void r_ccu_common_update_cpus_rate(void);
 void r_ccu_common_resume(void);
 void r_ccu_common_init(void);
 
@@ -12,6 +12,11 @@
 
 #include "clock.h"
 
+/* Cached rates are valid only if they match the current generation. */
+static uint16_t clock_rate_generation;
+/* Whether the rich OS is stopped, so only this firmware changes clocks. */
+static bool     clock_rates_cached;
+
 /**
  * Get the ops for the controller device providing this clock.
  */
@@ -42,6 +47,13 @@ clock_active(const struct clock_handle *clock)
 	return clock_state_for(clock)->refcount;
 }
 
+void
+clock_cache_rates(bool enable)
+{
+	clock_invalidate_rates();
+	clock_rates_cached = enable;
+}
+
 void
 clock_disable(const struct clock_handle *clock)
 {
@@ -102,14 +114,24 @@ clock_get_rate(const struct clock_handle *clock)
 {
 	const struct clock_driver_ops *ops = clock_ops_for(clock);
 	const struct clock_handle *parent;
+	struct clock_state *state = clock_state_for(clock);
 	uint32_t rate = 0;
 
+	/* Use the cached rate if nothing has changed since it was computed. */
+	if (clock_rates_cached && state->generation == clock_rate_generation)
+		return state->rate;
+
 	/* Initialize the rate with the parent's rate or a known safe value. */
 	if ((parent = ops->get_parent(clock)))
 		rate = clock_get_rate(parent);
 
 	/* Call the driver function to calculate this clock's rate. */
-	return ops->get_rate(clock, rate);
+	rate = ops->get_rate(clock, rate);
+
+	state->rate       = rate;
+	state->generation = clock_rate_generation;
+
+	return rate;
 }
 
 uint32_t
@@ -132,6 +154,14 @@ clock_get_state(const struct clock_handle *clock)
 	return ops->get_state(clock);
 }
 
+void
+clock_invalidate_rates(void)
+{
+	/* Zero is never valid, since it matches zero-initialized state. */
+	if (!++clock_rate_generation)
+		clock_rate_generation = 1;
+}
+
 void
 clock_put(const struct clock_handle *clock)
 {
@@ -15,7 +15,9 @@
 	&(char[sizeof_struct(struct clock_device_state, cs, n)]) { 0 }
 
 struct clock_state {
-	uint8_t refcount;
+	uint32_t rate;       /**< Cached rate, valid if generation matches. */
+	uint16_t generation; /**< Value of the rate generation counter. */
+	uint8_t  refcount;
 };
 
 struct clock_device_state {
@@ -37,4 +39,12 @@ struct clock_driver {
 	struct clock_driver_ops ops;
 };
 
+/**
+ * Invalidate the cached rates of all clocks.
+ *
+ * This must be called after changing anything that affects a clock's rate,
+ * such as its parent or divider, or the rate of a root clock.
+ */
+void clock_invalidate_rates(void);
+
 #endif /* CLOCK_PRIVATE_H */
@@ -3,9 +3,12 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <clock.h>
 #include <counter.h>
 #include <delay.h>
+#include <ktime.h>
 #include <mmio.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <system.h>
 #include <platform/devices.h>
@@ -18,9 +21,44 @@
 	                    PLL_CTRL_REG1_CRYSTAL_EN | \
 	                    PLL_CTRL_REG1_LDO_EN)
 
+/* The calibration interval, in system counter ticks (1/512 second). */
+#define IOSC_CAL_TICKS     (REFCLK_HZ >> 9)
+
+/*
+ * The saved calibration contains a tag, the number of boots since the value
+ * was last measured, and the number of IOSC cycles in 1/512 second.
+ */
+#define IOSC_CAL_REG       (DEV_RTC + 0x0100 + 0x4 * 1)
+#define IOSC_CAL_TAG       (0xc5U << 24)
+#define IOSC_CAL_TAG_MASK  (0xffU << 24)
+#define IOSC_CAL_AGE(x)    (((x) >> 16) & 0xff)
+#define IOSC_CAL_CYCLES(x) ((x) & 0xffff)
+#define IOSC_CAL_MAX_AGE   16
+
+/* The drift tracking interval, in system counter ticks (1 second). */
+#define IOSC_DRIFT_TICKS   REFCLK_HZ
+
+/* Each measurement moves the drift estimate 1/4 of the way. */
+#define IOSC_DRIFT_WEIGHT  4
+
+/* Update the IOSC rate once the estimate exceeds 1/128 (0.8%). */
+#define IOSC_DRIFT_SHIFT   7
+
+enum {
+	IOSC_CAL_IDLE,
+	IOSC_CAL_RUNNING,
+	IOSC_CAL_TRACKING,
+	IOSC_CAL_DONE,
+};
+
 /* Persist this var as r_ccu_init() may not be called after an exception. */
 static uint32_t iosc_rate = CPUCLK_Hz;
 
+static uint32_t cpus_rate;
+static uint32_t iosc_cal_cycles, iosc_cal_ticks;
+static int32_t  iosc_drift;
+static uint8_t  iosc_cal_state;
+
 DEFINE_FIXED_RATE(r_ccu_common_get_iosc_rate, iosc_rate)
 
 /**
@@ -43,6 +81,14 @@ r_ccu_common_suspend(uint8_t depth)
 	if (depth == SD_NONE)
 		return;
 
+	/* Rates derived from OSC24M change when it is disabled below. */
+	clock_invalidate_rates();
+
+	/* The system counter stops along with OSC24M. */
+	ktime_use_system_counter(false);
+	if (iosc_cal_state != IOSC_CAL_DONE)
+		iosc_cal_state = IOSC_CAL_IDLE;
+
 	if (CONFIG(OSC24M_SRC_X24M)) {
 		write_pll_ctrl_reg1(PLL_CTRL_REG1_LDO_EN);
 		udelay(1);
@@ -82,16 +128,204 @@ r_ccu_common_resume(void)
 			                    PLL_CTRL_REG1_LDO_EN);
 		}
 	}
+	clock_invalidate_rates();
+	ktime_use_system_counter(true);
 }
 
 void WEAK ATTRIBUTE(alias("r_ccu_common_resume"))
 r_ccu_resume(void);
 
+/**
+ * Propagate a change to the AR100 clock to everything that depends on it.
+ */
+void
+r_ccu_common_update_cpus_rate(void)
+{
+	static const struct clock_handle ar100 = {
+		.dev = &r_ccu.dev,
+		.id  = CLK_AR100,
+	};
+
+	/* Count the cycles so far at the old rate. */
+	ktime_poll();
+	clock_invalidate_rates();
+	cpus_rate = clock_get_rate(&ar100);
+	cycle_counter_set_rate(cpus_rate);
+
+	/* A background calibration is only valid if the clock is unchanged. */
+	if (iosc_cal_state != IOSC_CAL_DONE)
+		iosc_cal_state = IOSC_CAL_IDLE;
+	iosc_drift = 0;
+}
+
+/**
+ * Start a background measurement of the AR100 clock.
+ */
+static void
+iosc_cal_start(uint8_t state)
+{
+	iosc_cal_cycles = cycle_counter_read();
+	/* Ensure the counters are read in a consistent order. */
+	barrier();
+	iosc_cal_ticks = system_counter_read();
+	iosc_cal_state = state;
+}
+
+#if CONFIG(IOSC_CALIBRATION_CACHE)
+
+/**
+ * Save the calibrated IOSC rate, so the next boot can skip calibration.
+ */
+static void
+iosc_cal_save(uint8_t age)
+{
+	mmio_write_32(IOSC_CAL_REG, IOSC_CAL_TAG | age << 16 | iosc_rate >> 9);
+}
+
+/**
+ * Reuse the IOSC rate saved by a previous boot, if it is recent enough.
+ */
+static bool
+iosc_cal_restore(void)
+{
+	uint32_t val = mmio_read_32(IOSC_CAL_REG);
+	uint8_t  age = IOSC_CAL_AGE(val);
+
+	if ((val & IOSC_CAL_TAG_MASK) != IOSC_CAL_TAG ||
+	    age >= IOSC_CAL_MAX_AGE || !IOSC_CAL_CYCLES(val))
+		return false;
+
+	/* Count this boot, in case the refinement does not finish. */
+	iosc_rate = IOSC_CAL_CYCLES(val) << 9;
+	iosc_cal_save(age + 1);
+
+	return true;
+}
+
+#else
+
+static void
+iosc_cal_save(uint8_t age UNUSED)
+{
+}
+
+static bool
+iosc_cal_restore(void)
+{
+	return false;
+}
+
+#endif
+
+/**
+ * Check if the AR100 runs from IOSC, and the system counter is running, so
+ * IOSC drift can be measured.
+ *
+ * The system counter runs from OSC24M, so drift cannot be measured in any
+ * suspend depth below SD_NONE.
+ */
+static bool
+iosc_drift_measurable(void)
+{
+	uint32_t src = mmio_read_32(CPUS_CLK_REG) & CPUS_CLK_REG_CLK_SRC_MASK;
+
+	/* The AR100 rate is unknown until r_ccu_init() runs. */
+	return cpus_rate && src == CPUS_CLK_REG_CLK_SRC_IOSC &&
+	       mmio_get_32(PLL_CTRL_REG1, PLL_CTRL_REG1_LDO_EN);
+}
+
+/**
+ * Fold a measurement of the AR100 clock into the IOSC drift estimate.
+ *
+ * @param cycles The number of AR100 cycles in the interval.
+ * @param ticks  The number of system counter ticks in the interval.
+ * @return       Whether the estimate is large enough to update the IOSC rate.
+ */
+static bool
+iosc_track_drift(uint32_t cycles, uint32_t ticks)
+{
+	int32_t  limit = iosc_rate >> IOSC_DRIFT_SHIFT;
+	uint32_t scale = REFCLK_HZ >> 9;
+	uint32_t units = ticks >> 9;
+	uint32_t rate;
+
+	/* Convert to Hz in two steps, since cycles * scale overflows. */
+	rate  = cycles / units * scale;
+	rate += cycles % units * scale / units;
+
+	/* Undo the AR100 divider, then filter out measurement noise. */
+	rate *= iosc_rate / cpus_rate;
+	iosc_drift += ((int32_t)(rate - iosc_rate) - iosc_drift) /
+	              IOSC_DRIFT_WEIGHT;
+	if (iosc_drift > -limit && iosc_drift < limit)
+		return false;
+
+	iosc_rate += iosc_drift;
+
+	return true;
+}
+
+bool
+r_ccu_poll(void)
+{
+	uint32_t cycles, ticks, window;
+
+	if (iosc_cal_state == IOSC_CAL_DONE) {
+		iosc_cal_state = IOSC_CAL_IDLE;
+		return true;
+	}
+	if (iosc_cal_state == IOSC_CAL_IDLE) {
+		if (CONFIG(IOSC_DRIFT_TRACKING) && iosc_drift_measurable())
+			iosc_cal_start(IOSC_CAL_TRACKING);
+		return false;
+	}
+
+	cycles = cycle_counter_read();
+	/* Ensure the counters are read in a consistent order. */
+	barrier();
+	ticks = system_counter_read() - iosc_cal_ticks;
+	cycles -= iosc_cal_cycles;
+	window = iosc_cal_state == IOSC_CAL_RUNNING ? IOSC_CAL_TICKS
+	                                            : IOSC_DRIFT_TICKS;
+	if (ticks < window)
+		return false;
+
+	/* Restart if the main loop was delayed, to avoid overflow below. */
+	if (ticks > window + window / 2) {
+		iosc_cal_start(iosc_cal_state);
+		return false;
+	}
+
+	if (iosc_cal_state == IOSC_CAL_RUNNING) {
+		/* Scale the cycle count to exactly 1/512 second. */
+		iosc_rate = (cycles * IOSC_CAL_TICKS / ticks) << 9;
+	} else if (!iosc_track_drift(cycles, ticks)) {
+		iosc_cal_start(IOSC_CAL_TRACKING);
+		return false;
+	}
+	iosc_cal_save(0);
+	r_ccu_common_update_cpus_rate();
+
+	return true;
+}
+
 void
 r_ccu_common_init(void)
 {
 	uint32_t after, before, end, now;
 
+	ktime_use_system_counter(true);
+
+	/*
+	 * If a previous boot saved the calibrated rate, use it right away,
+	 * and refine it in the background from r_ccu_poll().
+	 */
+	if (iosc_cal_restore()) {
+		r_ccu_common_update_cpus_rate();
+		iosc_cal_start(IOSC_CAL_RUNNING);
+		return;
+	}
+
 	/* Cycle until the interval will not span a counter wraparound. */
 	do {
 		before = cycle_counter_read();
@@ -114,4 +348,9 @@ r_ccu_common_init(void)
 	 * reference clock frequency.
 	 */
 	iosc_rate = (after - before) << 9;
+	iosc_cal_save(0);
+
+	/* Both the CPUS clock parent and the IOSC rate may have changed. */
+	r_ccu_common_update_cpus_rate();
+	iosc_cal_state = IOSC_CAL_DONE;
 }
@@ -7,6 +7,7 @@
 #include <clock.h>
 #include <device.h>
 #include <stdint.h>
+#include <util.h>
 #include <clock/ccu.h>
 #include <platform/devices.h>
 
@@ -131,10 +132,64 @@ const struct ccu ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN50I_H6_CCU_CLOCKS),
 	},
-	.clocks = ccu_clocks,
-	.regs   = DEV_CCU,
+	.clocks  = ccu_clocks,
+	.regs    = DEV_CCU,
+	.nclocks = SUN50I_H6_CCU_CLOCKS,
 };
 
+#if CONFIG(CCU_GATE_AUDIT)
+
+/* Each bus gating/reset register has its gates in the low half. */
+const struct ccu_gate_reg ccu_gate_regs[] = {
+	{ .reg = 0x060c, .gates = 0x0000ffff },
+	{ .reg = 0x062c, .gates = 0x0000ffff },
+	{ .reg = 0x063c, .gates = 0x0000ffff },
+	{ .reg = 0x067c, .gates = 0x0000ffff },
+	{ .reg = 0x068c, .gates = 0x0000ffff },
+	{ .reg = 0x069c, .gates = 0x0000ffff },
+	{ .reg = 0x06bc, .gates = 0x0000ffff },
+	{ .reg = 0x06cc, .gates = 0x0000ffff },
+	{ .reg = 0x070c, .gates = 0x0000ffff },
+	{ .reg = 0x071c, .gates = 0x0000ffff },
+	{ .reg = 0x072c, .gates = 0x0000ffff },
+	{ .reg = 0x073c, .gates = 0x0000ffff },
+	{ .reg = 0x078c, .gates = 0x0000ffff },
+	{ .reg = 0x079c, .gates = 0x0000ffff },
+	{ .reg = 0x07ac, .gates = 0x0000ffff },
+	{ .reg = 0x07bc, .gates = 0x0000ffff },
+	{ .reg = 0x080c, .gates = 0x0000ffff },
+	{ .reg = 0x082c, .gates = 0x0000ffff },
+	{ .reg = 0x084c, .gates = 0x0000ffff },
+	{ .reg = 0x090c, .gates = 0x0000ffff },
+	{ .reg = 0x091c, .gates = 0x0000ffff },
+	{ .reg = 0x093c, .gates = 0x0000ffff },
+	{ .reg = 0x096c, .gates = 0x0000ffff },
+	{ .reg = 0x097c, .gates = 0x0000ffff },
+	{ .reg = 0x09bc, .gates = 0x0000ffff },
+	{ .reg = 0x09fc, .gates = 0x0000ffff },
+	{ .reg = 0x0a1c, .gates = 0x0000ffff },
+	{ .reg = 0x0a2c, .gates = 0x0000ffff },
+	{ .reg = 0x0a4c, .gates = 0x0000ffff },
+	{ .reg = 0x0a6c, .gates = 0x0000ffff },
+	{ .reg = 0x0a8c, .gates = 0x0000ffff },
+	{ .reg = 0x0abc, .gates = 0x0000ffff },
+	/* The HDMI CEC controller may be used for wakeup. */
+	{ .reg = 0x0b1c, .gates = 0x0000ffff,
+	  .keep = CONFIG(CEC) ? BIT(0) : 0 },
+	{ .reg = 0x0b5c, .gates = 0x0000ffff },
+	{ .reg = 0x0b7c, .gates = 0x0000ffff },
+	{ .reg = 0x0b9c, .gates = 0x0000ffff },
+	{ .reg = 0x0c2c, .gates = 0x0000ffff },
+	{ .reg = 0x0c4c, .gates = 0x0000ffff },
+};
+
+const uint8_t ccu_ngate_regs = ARRAY_SIZE(ccu_gate_regs);
+
+static_assert(ARRAY_SIZE(ccu_gate_regs) <= CCU_GATE_REGS_MAX,
+              "Too many gate registers to audit");
+
+#endif
+
 void
 ccu_suspend(void)
 {
@@ -8,6 +8,7 @@
 #include <clock.h>
 #include <device.h>
 #include <stdint.h>
+#include <util.h>
 #include <clock/ccu.h>
 #include <platform/devices.h>
 
@@ -164,10 +165,29 @@ const struct ccu ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN8I_A23_CCU_CLOCKS),
 	},
-	.clocks = ccu_clocks,
-	.regs   = DEV_CCU,
+	.clocks  = ccu_clocks,
+	.regs    = DEV_CCU,
+	.nclocks = SUN8I_A23_CCU_CLOCKS,
 };
 
+#if CONFIG(CCU_GATE_AUDIT)
+
+const struct ccu_gate_reg ccu_gate_regs[] = {
+	{ .reg = 0x0060, .gates = 0xffffffff },
+	{ .reg = 0x0064, .gates = 0xffffffff },
+	/* Port interrupts may be used for wakeup. */
+	{ .reg = 0x0068, .gates = 0xffffffff, .keep = BIT(5) },
+	{ .reg = 0x006c, .gates = 0xffffffff },
+	{ .reg = 0x0070, .gates = 0xffffffff },
+};
+
+const uint8_t ccu_ngate_regs = ARRAY_SIZE(ccu_gate_regs);
+
+static_assert(ARRAY_SIZE(ccu_gate_regs) <= CCU_GATE_REGS_MAX,
+              "Too many gate registers to audit");
+
+#endif
+
 static const struct clock_handle pll_cpux = {
 	.dev = &ccu.dev,
 	.id  = CLK_PLL_CPUX,
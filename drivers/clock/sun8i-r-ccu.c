@@ -17,6 +17,9 @@
 
 #include "ccu.h"
 
+#define PLL_PERIPH0_CTRL_REG (DEV_CCU + 0x0028)
+#define PLL_PERIPH0_ENABLE   BIT(31)
+
 static DEFINE_FIXED_RATE(r_ccu_get_osc24m_rate, 24000000U)
 static DEFINE_FIXED_RATE(r_ccu_get_osc32k_rate, 32768U)
 
@@ -184,10 +187,38 @@ const struct ccu r_ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN8I_R_CCU_CLOCKS),
 	},
-	.clocks = r_ccu_clocks,
-	.regs   = DEV_R_PRCM,
+	.clocks  = r_ccu_clocks,
+	.regs    = DEV_R_PRCM,
+	.nclocks = SUN8I_R_CCU_CLOCKS,
 };
 
+void
+r_ccu_set_cpus_clock(bool boost)
+{
+	if (CONFIG(CPUS_CLK_BOOST) && boost &&
+	    mmio_get_32(PLL_PERIPH0_CTRL_REG, PLL_PERIPH0_ENABLE)) {
+		/* Set APB0 to AHB0/4 (50 MHz) before raising the AHB0 rate. */
+		mmio_write_32(APB0_CLK_REG, APB0_CLK_REG_DIV_M(3));
+		/* Set CPUS to PLL_PERIPH0/3 (200 MHz). */
+		mmio_write_32(CPUS_CLK_REG,
+		              CPUS_CLK_REG_CLK_SRC(2) |
+		              CPUS_CLK_REG_PRE_DIV(2) |
+		              CPUS_CLK_REG_DIV_P(0));
+	} else {
+		uint8_t shift = boost ? 0 : CONFIG_CPUS_CLK_SLEEP_SHIFT;
+
+		/* Set CPUS to IOSC/2^N. */
+		mmio_write_32(CPUS_CLK_REG,
+		              CPUS_CLK_REG_CLK_SRC(3) |
+		              CPUS_CLK_REG_PRE_DIV(0) |
+		              CPUS_CLK_REG_DIV_P(shift));
+		/* Set APB0 to AHB0/1 after lowering the AHB0 rate. */
+		mmio_write_32(APB0_CLK_REG, APB0_CLK_REG_DIV_M(0));
+	}
+
+	r_ccu_common_update_cpus_rate();
+}
+
 void
 r_ccu_init(void)
 {
@@ -197,5 +228,8 @@ r_ccu_init(void)
 	              CPUS_CLK_REG_PRE_DIV(0) |
 	              CPUS_CLK_REG_DIV_P(0));
 
+	/* Reset APB0 to AHB0/1, in case it was divided for a boost. */
+	mmio_write_32(APB0_CLK_REG, APB0_CLK_REG_DIV_M(0));
+
 	r_ccu_common_init();
 }
@@ -198,22 +198,24 @@ dram_suspend(void)
 	udelay(10);
 	/* Disable DRAM controller clocks. */
 	mmio_write_32(CLKEN, 0);
+	ccu_batch_begin();
 	clock_put(&dram_clocks[DRAM]);
 	clock_put(&dram_clocks[MBUS]);
 
 	/* Disable further DRAM controller register access. */
 	clock_put(&dram_clocks[BUS_DRAM]);
+	ccu_batch_commit();
 }
 
 void
 dram_resume(void)
 {
-	/* Enable DRAM controller register access. */
+	/* Enable DRAM controller register access and clocks. */
+	ccu_batch_begin();
 	clock_get(&dram_clocks[BUS_DRAM]);
-
-	/* Enable DRAM controller clocks. */
 	clock_get(&dram_clocks[MBUS]);
 	clock_get(&dram_clocks[DRAM]);
+	ccu_batch_commit();
 	mmio_write_32(CLKEN, CLKEN_VALUE);
 	/* Configure AC pads. */
 	mmio_clrset_32(ACIOCR0,
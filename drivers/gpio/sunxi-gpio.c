@@ -4,11 +4,13 @@
  */
 
 #include <bitfield.h>
+#include <device.h>
 #include <error.h>
 #include <limits.h>
 #include <mmio.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <util.h>
 #include <clock/ccu.h>
 #include <gpio/sunxi-gpio.h>
 #include <platform/devices.h>
@@ -35,6 +37,15 @@
 #define PULL_REG(port, pin)  (0x001c + 0x24 * (port) + 4 * ((pin) / PULL_PPW))
 #define PULL_BIT(pin)        (PULL_WIDTH * ((pin) % PULL_PPW))
 
+#define INT_CFG_WIDTH        4
+#define INT_CFG_PPW          (WORD_BIT / INT_CFG_WIDTH)
+#define INT_CFG_REG(bank, pin) \
+	(0x0200 + 0x20 * (bank) + 4 * ((pin) / INT_CFG_PPW))
+#define INT_CFG_BIT(pin)     (INT_CFG_WIDTH * ((pin) % INT_CFG_PPW))
+#define INT_CTL_REG(bank)    (0x0210 + 0x20 * (bank))
+#define INT_STA_REG(bank)    (0x0214 + 0x20 * (bank))
+#define INT_DEB_REG(bank)    (0x0218 + 0x20 * (bank))
+
 #define PINS_PER_PORT        32
 #define GET_PORT(gpio)       ((gpio)->id / PINS_PER_PORT)
 #define GET_PIN(gpio)        ((gpio)->id % PINS_PER_PORT)
@@ -113,6 +124,122 @@ const struct simple_device pio = {
 	.regs  = DEV_PIO,
 };
 
+#if CONFIG(R_PIO_WAKE)
+
+/* Port L is the first (and usually only) interrupt bank of R_PIO. */
+#define WAKE_BANK            0
+#define WAKE_PORT            0
+#define WAKE_PINS            16
+
+#define WAKE_PULL            (CONFIG(R_PIO_WAKE_PULL_UP) ? PULL_UP : PULL_NONE)
+
+/* Wakeup configuration, used instead of the Kconfig default once set. */
+static bool     wake_set;
+static uint32_t wake_pins;
+static uint8_t  wake_trigger;
+
+/* Register values from before the pins were configured for wakeup. */
+static uint32_t saved_mode[WAKE_PINS / MODE_PPW];
+static uint32_t saved_int_cfg[WAKE_PINS / INT_CFG_PPW];
+static uint32_t saved_int_ctl, saved_int_deb, saved_pull;
+
+int
+sunxi_gpio_set_wake(uint32_t pins, uint8_t trigger)
+{
+	if (pins == SUNXI_GPIO_WAKE_DEFAULT) {
+		wake_set = false;
+		return SUCCESS;
+	}
+	if (pins >> WAKE_PINS || trigger > TRIGGER_BOTH)
+		return EINVAL;
+
+	wake_set     = true;
+	wake_pins    = pins;
+	wake_trigger = trigger;
+
+	return SUCCESS;
+}
+
+const struct device *
+sunxi_gpio_wake_get(void)
+{
+	uintptr_t regs    = r_pio.regs;
+	uint32_t  pins    = wake_set ? wake_pins : CONFIG_R_PIO_WAKE_PINS;
+	uint8_t   trigger = wake_set ? wake_trigger : CONFIG_R_PIO_WAKE_TRIGGER;
+
+	if (!pins || device_get(&r_pio.dev))
+		return NULL;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(saved_mode); ++i) {
+		uintptr_t reg = regs + MODE_REG(WAKE_PORT, i * MODE_PPW);
+		saved_mode[i] = mmio_read_32(reg);
+	}
+	for (uint8_t i = 0; i < ARRAY_SIZE(saved_int_cfg); ++i) {
+		uintptr_t reg = regs + INT_CFG_REG(WAKE_BANK, i * INT_CFG_PPW);
+		saved_int_cfg[i] = mmio_read_32(reg);
+	}
+	saved_int_ctl = mmio_read_32(regs + INT_CTL_REG(WAKE_BANK));
+	saved_int_deb = mmio_read_32(regs + INT_DEB_REG(WAKE_BANK));
+	saved_pull    = mmio_read_32(regs + PULL_REG(WAKE_PORT, 0));
+
+	/* Sample inputs with the 32 kHz clock, which runs at every depth. */
+	mmio_write_32(regs + INT_DEB_REG(WAKE_BANK), 0);
+
+	for (uint8_t pin = 0; pin < WAKE_PINS; ++pin) {
+		if (!(pins & BIT(pin)))
+			continue;
+
+		mmio_set_bitfield_32(regs + INT_CFG_REG(WAKE_BANK, pin),
+		                     INT_CFG_BIT(pin), INT_CFG_WIDTH, trigger);
+		mmio_set_bitfield_32(regs + PULL_REG(WAKE_PORT, pin),
+		                     PULL_BIT(pin), PULL_WIDTH, WAKE_PULL);
+		mmio_set_bitfield_32(regs + MODE_REG(WAKE_PORT, pin),
+		                     MODE_BIT(pin), MODE_WIDTH, MODE_EINT);
+	}
+
+	/* Discard any events latched before the pins were configured. */
+	mmio_write_32(regs + INT_STA_REG(WAKE_BANK), pins);
+	mmio_set_32(regs + INT_CTL_REG(WAKE_BANK), pins);
+
+	return &r_pio.dev;
+}
+
+uint32_t
+sunxi_gpio_wake_poll(const struct device *dev)
+{
+	const struct simple_device *self = to_simple_device(dev);
+	uint32_t enabled = mmio_read_32(self->regs + INT_CTL_REG(WAKE_BANK));
+	uint32_t status  = mmio_read_32(self->regs + INT_STA_REG(WAKE_BANK));
+
+	return status & enabled;
+}
+
+void
+sunxi_gpio_wake_put(const struct device *dev)
+{
+	uintptr_t regs;
+
+	if (!dev)
+		return;
+
+	regs = to_simple_device(dev)->regs;
+
+	/* Leave pending events in place for the rich OS to see. */
+	mmio_write_32(regs + INT_CTL_REG(WAKE_BANK), saved_int_ctl);
+	mmio_write_32(regs + INT_DEB_REG(WAKE_BANK), saved_int_deb);
+	mmio_write_32(regs + PULL_REG(WAKE_PORT, 0), saved_pull);
+	for (uint8_t i = 0; i < ARRAY_SIZE(saved_int_cfg); ++i)
+		mmio_write_32(regs + INT_CFG_REG(WAKE_BANK, i * INT_CFG_PPW),
+		              saved_int_cfg[i]);
+	for (uint8_t i = 0; i < ARRAY_SIZE(saved_mode); ++i)
+		mmio_write_32(regs + MODE_REG(WAKE_PORT, i * MODE_PPW),
+		              saved_mode[i]);
+
+	device_put(dev);
+}
+
+#endif
+
 const struct simple_device r_pio = {
 	.dev = {
 		.name  = "r_pio",
@@ -7,7 +7,9 @@
 #include <mmio.h>
 #include <stdint.h>
 #include <util.h>
+#include <mfd/axp20x.h>
 #include <platform/devices.h>
+#include <platform/irq.h>
 
 #include "irq.h"
 
@@ -101,5 +103,30 @@ irq_poll(void)
 	for (int i = 0; i < NUM_IRQ_REGS; ++i)
 		pending |= mmio_read_32(DEV_R_INTC + INTC_IRQ_PEND_REG(i));
 
+#if CONFIG(CIR)
+	/*
+	 * The CIR driver enables receiver events so it can drain the FIFO.
+	 * These raise the R_CIR interrupt for any IR activity, so ignore it.
+	 * The CIR driver wakes the system only after matching a scan code.
+	 */
+	pending &= ~BIT(IRQ_R_CIR_RX);
+#endif
+
+	/*
+	 * The PMIC interrupt is connected to the NMI. When the PMIC event is
+	 * discarded, the PMIC releases the line, so clear the latched NMI.
+	 * During the holdoff, keep the NMI latched without waking, so events
+	 * arriving then (such as a power key press) are decoded afterward.
+	 */
+	if (CONFIG(MFD_AXP20X_IRQ) && (pending & BIT(IRQ_NMI))) {
+		if (axp20x_irq_held_off()) {
+			pending &= ~BIT(IRQ_NMI);
+		} else if (!axp20x_irq_poll()) {
+			mmio_write_32(DEV_R_INTC + INTC_IRQ_PEND_REG(0),
+			              BIT(IRQ_NMI));
+			pending &= ~BIT(IRQ_NMI);
+		}
+	}
+
 	return pending;
 }
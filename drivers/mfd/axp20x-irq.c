@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <debug.h>
+#include <ktime.h>
+#include <regmap.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
+#include <mfd/axp20x.h>
+
+#define IRQ_ENABLE_REG 0x40
+#define IRQ_STATUS_REG 0x48
+
+#if CONFIG(MFD_AXP223)
+#define IRQ_BANKS      5
+#elif CONFIG(MFD_AXP803)
+#define IRQ_BANKS      6
+#elif CONFIG(MFD_AXP805)
+#define IRQ_BANKS      2
+#endif
+
+/*
+ * Sources that never wake the system. Events for these sources are
+ * acknowledged in the PMIC, so they are never seen by the rich OS.
+ */
+static const uint8_t axp20x_irq_ignore[IRQ_BANKS] = {
+#if (CONFIG(MFD_AXP223) || CONFIG(MFD_AXP803)) && \
+	!CONFIG(MFD_AXP20X_IRQ_CHARGER_WAKE)
+	[0] = BIT(6) | /* ACIN plug in */
+	      BIT(5) | /* ACIN removal */
+	      BIT(3) | /* VBUS plug in */
+	      BIT(2),  /* VBUS removal */
+	[1] = BIT(5) | /* Battery enters activation mode */
+	      BIT(4) | /* Battery exits activation mode */
+	      BIT(3) | /* Charging started */
+	      BIT(2),  /* Charging finished */
+#if CONFIG(MFD_AXP803)
+	[5] = BIT(1) | /* BC 1.2 detection result changed */
+	      BIT(0),  /* Charger mode changed */
+#endif
+#endif
+};
+
+/* Until this time, pending PMIC interrupts are left alone. */
+static uint64_t holdoff;
+
+bool
+axp20x_irq_held_off(void)
+{
+	return !ktime_expired(holdoff);
+}
+
+uint32_t
+axp20x_irq_poll(void)
+{
+	const struct regmap *map = &axp20x.map;
+	uint8_t  enabled[IRQ_BANKS], status[IRQ_BANKS];
+	uint32_t wake = 0;
+
+	/* Without any way to decode the interrupt, wake the system. */
+	if (regmap_user_probe(map))
+		return 1;
+	if (regmap_read_bulk(map, IRQ_ENABLE_REG, enabled, IRQ_BANKS) ||
+	    regmap_read_bulk(map, IRQ_STATUS_REG, status, IRQ_BANKS)) {
+		wake = 1;
+		goto out;
+	}
+
+	for (uint8_t i = 0; i < IRQ_BANKS; ++i) {
+		uint8_t pending = status[i] & enabled[i];
+		uint8_t ignored = pending & axp20x_irq_ignore[i];
+
+		/* Leave wakeup events pending for the rich OS to handle. */
+		wake |= pending & ~ignored;
+
+		/* Status bits are cleared by writing a one to them. */
+		if (ignored) {
+			debug("PMIC IRQ bank %u: ignoring 0x%02x", i, ignored);
+			regmap_write(map, IRQ_STATUS_REG + i, ignored);
+		}
+	}
+
+	/* Coalesce any further events, such as from a bouncing connector. */
+	if (!wake)
+		holdoff = ktime_add_ms(ktime_get(),
+		                       CONFIG_MFD_AXP20X_IRQ_DEBOUNCE);
+
+out:
+	regmap_user_release(map);
+
+	return wake;
+}
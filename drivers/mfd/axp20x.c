@@ -6,7 +6,9 @@
 #include <device.h>
 #include <error.h>
 #include <regmap.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <util.h>
 #include <mfd/axp20x.h>
 #include <regmap/sun6i-i2c.h>
 #include <regmap/sunxi-rsb.h>
@@ -28,6 +30,24 @@
 #define RSB_ADDRESS   (0x3a << 16 | 0x745)
 #endif
 
+/*
+ * Only the regulator output enable banks are cached. These are the registers
+ * modified on every suspend and resume, and the PMIC only changes them on its
+ * own while the system is suspended. Register 0x11 is unused on some variants,
+ * but caching it allows the whole bank to be served from the cache.
+ */
+static const uint8_t axp20x_cached_regs[] = { 0x10, 0x11, 0x12, 0x13 };
+
+static uint8_t  axp20x_cache_vals[ARRAY_SIZE(axp20x_cached_regs)];
+static uint32_t axp20x_cache_valid;
+
+static const struct regmap_cache axp20x_cache = {
+	.regs  = axp20x_cached_regs,
+	.vals  = axp20x_cache_vals,
+	.valid = &axp20x_cache_valid,
+	.count = ARRAY_SIZE(axp20x_cached_regs),
+};
+
 static int
 axp20x_probe(const struct device *dev)
 {
@@ -44,6 +64,10 @@ axp20x_probe(const struct device *dev)
 		goto err_release;
 	}
 
+	/* Speed up the bus, using the IC type to validate the link. Failure
+	 * is not fatal, because the bus keeps working at the default rate. */
+	regmap_tune_rate(&self->map, IC_TYPE_REG);
+
 	return SUCCESS;
 
 err_release:
@@ -64,7 +88,8 @@ const struct regmap_device axp20x = {
 		.state = DEVICE_STATE_INIT,
 	},
 	.map = {
-		.dev = CONFIG(RSB) ? &r_rsb.dev : &r_i2c.dev,
-		.id  = CONFIG(RSB) ? RSB_ADDRESS : I2C_ADDRESS,
+		.dev   = CONFIG(RSB) ? &r_rsb.dev : &r_i2c.dev,
+		.id    = CONFIG(RSB) ? RSB_ADDRESS : I2C_ADDRESS,
+		.cache = CONFIG(REGMAP_CACHE) ? &axp20x_cache : NULL,
 	},
 };
@@ -22,6 +22,9 @@ axp20x_pmic_resume(const struct device *dev)
 {
 	const struct axp20x_pmic *self = to_axp20x_pmic(dev);
 
+	/* The PMIC changes its output enable bits on its own while asleep. */
+	regmap_invalidate_cache(self->map);
+
 	/* Trigger soft power resume. */
 	return regmap_set_bits(self->map, WAKEUP_CTRL_REG, BIT(5));
 }
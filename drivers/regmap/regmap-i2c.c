@@ -3,9 +3,12 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <counter.h>
+#include <debug.h>
 #include <device.h>
 #include <error.h>
 #include <intrusive.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "regmap-i2c.h"
@@ -23,6 +26,32 @@ regmap_i2c_ops_for(const struct regmap *map)
 	return &drv->ops;
 }
 
+/**
+ * Record the start time of a transaction, if tracing is enabled.
+ */
+static inline uint32_t
+regmap_i2c_trace_begin(void)
+{
+	return CONFIG(DEBUG_TRACE_I2C) ? cycle_counter_read() : 0;
+}
+
+/**
+ * Print the duration of a transaction, if tracing is enabled.
+ */
+static inline void
+regmap_i2c_trace_end(const char *op, uint8_t reg, uint8_t count,
+                     uint32_t start)
+{
+	if (CONFIG(DEBUG_TRACE_I2C)) {
+		uint32_t cycles = cycle_counter_read() - start;
+		uint32_t khz    = cycle_counter_rate_khz();
+
+		debug("I2C %s 0x%02x (%u bytes) took %u us",
+		      op, reg, count,
+		      cycles / khz * 1000 + cycles % khz * 1000 / khz);
+	}
+}
+
 int
 regmap_i2c_prepare(const struct regmap *map)
 {
@@ -35,7 +64,7 @@ regmap_i2c_prepare(const struct regmap *map)
 		goto abort;
 
 	/* Read data to avoid putting the device in an inconsistent state. */
-	if (ops->read(map, &dummy))
+	if (ops->read(map, &dummy, false))
 		goto abort;
 
 abort:
@@ -49,6 +78,7 @@ int
 regmap_i2c_read(const struct regmap *map, uint8_t reg, uint8_t *val)
 {
 	const struct regmap_i2c_driver_ops *ops = regmap_i2c_ops_for(map);
+	uint32_t start = regmap_i2c_trace_begin();
 	int err;
 
 	/* Start a write transaction. */
@@ -64,12 +94,13 @@ regmap_i2c_read(const struct regmap *map, uint8_t reg, uint8_t *val)
 		goto abort;
 
 	/* Read the register value. */
-	if ((err = ops->read(map, val)))
+	if ((err = ops->read(map, val, false)))
 		goto abort;
 
 abort:
 	/* Finish the transaction. */
 	ops->stop(map);
+	regmap_i2c_trace_end("read", reg, 1, start);
 
 	return err;
 }
@@ -78,6 +109,7 @@ int
 regmap_i2c_write(const struct regmap *map, uint8_t reg, uint8_t val)
 {
 	const struct regmap_i2c_driver_ops *ops = regmap_i2c_ops_for(map);
+	uint32_t start = regmap_i2c_trace_begin();
 	int err;
 
 	/* Start a write transaction. */
@@ -95,6 +127,74 @@ regmap_i2c_write(const struct regmap *map, uint8_t reg, uint8_t val)
 abort:
 	/* Finish the transaction. */
 	ops->stop(map);
+	regmap_i2c_trace_end("write", reg, 1, start);
+
+	return err;
+}
+
+int
+regmap_i2c_read_bulk(const struct regmap *map, uint8_t reg, uint8_t *vals,
+                     uint8_t count)
+{
+	const struct regmap_i2c_driver_ops *ops = regmap_i2c_ops_for(map);
+	uint32_t start = regmap_i2c_trace_begin();
+	int err;
+
+	/* Start a write transaction. */
+	if ((err = ops->start(map, I2C_WRITE)))
+		goto abort;
+
+	/* Write the first register address. */
+	if ((err = ops->write(map, reg)))
+		goto abort;
+
+	/* Restart as a read transaction. */
+	if ((err = ops->start(map, I2C_READ)))
+		goto abort;
+
+	/* Read the register values, acknowledging all but the last. */
+	for (uint8_t i = 0; i < count; ++i) {
+		if ((err = ops->read(map, &vals[i], i + 1 < count)))
+			goto abort;
+	}
+
+abort:
+	/* Finish the transaction. */
+	ops->stop(map);
+	regmap_i2c_trace_end("read", reg, count, start);
+
+	return err;
+}
+
+int
+regmap_i2c_write_bulk(const struct regmap *map, uint8_t reg,
+                      const uint8_t *vals, uint8_t count)
+{
+	const struct regmap_i2c_driver_ops *ops = regmap_i2c_ops_for(map);
+	uint32_t start = regmap_i2c_trace_begin();
+	int err;
+
+	/* Start a write transaction. */
+	if ((err = ops->start(map, I2C_WRITE)))
+		goto abort;
+
+	/*
+	 * X-Powers PMICs do not advance the register address during a write.
+	 * Their datasheets define a multi-byte write as a sequence of register
+	 * address and data pairs within one transaction, so send each value
+	 * with its own address.
+	 */
+	for (uint8_t i = 0; i < count; ++i) {
+		if ((err = ops->write(map, reg + i)))
+			goto abort;
+		if ((err = ops->write(map, vals[i])))
+			goto abort;
+	}
+
+abort:
+	/* Finish the transaction. */
+	ops->stop(map);
+	regmap_i2c_trace_end("write", reg, count, start);
 
 	return err;
 }
@@ -6,6 +6,9 @@
 #ifndef REGMAP_I2C_PRIVATE_H
 #define REGMAP_I2C_PRIVATE_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "regmap.h"
 
 enum {
@@ -14,7 +17,7 @@ enum {
 };
 
 struct regmap_i2c_driver_ops {
-	int  (*read)(const struct regmap *map, uint8_t *data);
+	int  (*read)(const struct regmap *map, uint8_t *data, bool ack);
 	int  (*start)(const struct regmap *map, uint8_t direction);
 	void (*stop)(const struct regmap *map);
 	int  (*write)(const struct regmap *map, uint8_t data);
@@ -31,4 +34,10 @@ int regmap_i2c_read(const struct regmap *map, uint8_t reg, uint8_t *val);
 
 int regmap_i2c_write(const struct regmap *map, uint8_t reg, uint8_t val);
 
+int regmap_i2c_read_bulk(const struct regmap *map, uint8_t reg, uint8_t *vals,
+                         uint8_t count);
+
+int regmap_i2c_write_bulk(const struct regmap *map, uint8_t reg,
+                          const uint8_t *vals, uint8_t count);
+
 #endif /* REGMAP_I2C_PRIVATE_H */
@@ -7,7 +7,9 @@
 #include <error.h>
 #include <intrusive.h>
 #include <regmap.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <util.h>
 
 #include "regmap.h"
 
@@ -23,6 +25,86 @@ regmap_ops_for(const struct regmap *map)
 	return &drv->ops;
 }
 
+/**
+ * Find the index of a register in a regmap's cache.
+ *
+ * @return The index of the register, or -1 if the register is not cached.
+ */
+static int
+regmap_cache_index(const struct regmap *map, uint8_t reg)
+{
+	const struct regmap_cache *cache = map->cache;
+
+	if (!CONFIG(REGMAP_CACHE) || !cache)
+		return -1;
+
+	/* The list is sorted, so stop once it passes the register. */
+	for (uint8_t i = 0; i < cache->count && cache->regs[i] <= reg; ++i) {
+		if (cache->regs[i] == reg)
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Look up a register value in a regmap's cache.
+ *
+ * @return True if a valid value was found.
+ */
+static bool
+regmap_cache_lookup(const struct regmap *map, uint8_t reg, uint8_t *val)
+{
+	int index = regmap_cache_index(map, reg);
+
+	if (index < 0 || !(*map->cache->valid & BIT(index)))
+		return false;
+
+	*val = map->cache->vals[index];
+
+	return true;
+}
+
+/**
+ * Record a value read from or written to a register, if it is cacheable.
+ */
+static void
+regmap_cache_store(const struct regmap *map, uint8_t reg, uint8_t val)
+{
+	int index = regmap_cache_index(map, reg);
+
+	if (index < 0)
+		return;
+
+	map->cache->vals[index] = val;
+	*map->cache->valid     |= BIT(index);
+}
+
+/**
+ * Forget a register value after a failed write left it unknown.
+ */
+static void
+regmap_cache_drop(const struct regmap *map, uint8_t reg)
+{
+	int index = regmap_cache_index(map, reg);
+
+	if (index < 0)
+		return;
+
+	*map->cache->valid &= ~BIT(index);
+}
+
+#if CONFIG(REGMAP_CACHE)
+
+void
+regmap_invalidate_cache(const struct regmap *map)
+{
+	if (map->cache)
+		*map->cache->valid = 0;
+}
+
+#endif
+
 int
 regmap_get(const struct regmap *map)
 {
@@ -35,6 +117,9 @@ regmap_get(const struct regmap *map)
 	if ((err = regmap_ops_for(map)->prepare(map)))
 		goto err_put_device;
 
+	/* The device may have been reset since its registers were cached. */
+	regmap_invalidate_cache(map);
+
 	return SUCCESS;
 
 err_put_device:
@@ -52,27 +137,126 @@ regmap_put(const struct regmap *map)
 int
 regmap_read(const struct regmap *map, uint8_t reg, uint8_t *val)
 {
-	return regmap_ops_for(map)->read(map, reg, val);
+	int err;
+
+	if (regmap_cache_lookup(map, reg, val))
+		return SUCCESS;
+
+	if ((err = regmap_ops_for(map)->read(map, reg, val)))
+		return err;
+
+	regmap_cache_store(map, reg, *val);
+
+	return SUCCESS;
 }
 
 int
 regmap_write(const struct regmap *map, uint8_t reg, uint8_t val)
 {
-	return regmap_ops_for(map)->write(map, reg, val);
+	uint8_t old;
+	int err;
+
+	/* Skip writes that would not change the register. */
+	if (regmap_cache_lookup(map, reg, &old) && old == val)
+		return SUCCESS;
+
+	if ((err = regmap_ops_for(map)->write(map, reg, val))) {
+		regmap_cache_drop(map, reg);
+		return err;
+	}
+
+	regmap_cache_store(map, reg, val);
+
+	return SUCCESS;
+}
+
+int
+regmap_read_bulk(const struct regmap *map, uint8_t reg, uint8_t *vals,
+                 uint8_t count)
+{
+	const struct regmap_driver_ops *ops = regmap_ops_for(map);
+	uint8_t cached = 0;
+	int err;
+
+	while (cached < count &&
+	       regmap_cache_lookup(map, reg + cached, &vals[cached]))
+		++cached;
+	if (cached == count)
+		return SUCCESS;
+
+	if (ops->read_bulk) {
+		if ((err = ops->read_bulk(map, reg, vals, count)))
+			return err;
+	} else {
+		for (uint8_t i = 0; i < count; ++i) {
+			if ((err = ops->read(map, reg + i, &vals[i])))
+				return err;
+		}
+	}
+
+	for (uint8_t i = 0; i < count; ++i)
+		regmap_cache_store(map, reg + i, vals[i]);
+
+	return SUCCESS;
+}
+
+int
+regmap_write_bulk(const struct regmap *map, uint8_t reg,
+                  const uint8_t *vals, uint8_t count)
+{
+	const struct regmap_driver_ops *ops = regmap_ops_for(map);
+	uint8_t unchanged = 0, old;
+	int err = SUCCESS;
+
+	/* Skip writes that would not change any register. */
+	while (unchanged < count &&
+	       regmap_cache_lookup(map, reg + unchanged, &old) &&
+	       old == vals[unchanged])
+		++unchanged;
+	if (unchanged == count)
+		return SUCCESS;
+
+	if (ops->write_bulk) {
+		err = ops->write_bulk(map, reg, vals, count);
+	} else {
+		for (uint8_t i = 0; i < count && !err; ++i)
+			err = ops->write(map, reg + i, vals[i]);
+	}
+
+	for (uint8_t i = 0; i < count; ++i) {
+		if (err)
+			regmap_cache_drop(map, reg + i);
+		else
+			regmap_cache_store(map, reg + i, vals[i]);
+	}
+
+	return err;
 }
 
 int
 regmap_update_bits(const struct regmap *map, uint8_t reg, uint8_t mask,
                    uint8_t val)
 {
-	const struct regmap_driver_ops *ops = regmap_ops_for(map);
 	uint8_t tmp;
 	int err;
 
-	if ((err = ops->read(map, reg, &tmp)))
+	/* Both steps go through the cache, so a cached register is only
+	 * written, and only if its value changes. */
+	if ((err = regmap_read(map, reg, &tmp)))
 		return err;
 
-	return ops->write(map, reg, tmp ^ ((val ^ tmp) & mask));
+	return regmap_write(map, reg, tmp ^ ((val ^ tmp) & mask));
+}
+
+int
+regmap_tune_rate(const struct regmap *map, uint8_t reg)
+{
+	const struct regmap_driver_ops *ops = regmap_ops_for(map);
+
+	if (!ops->tune_rate)
+		return ENOTSUP;
+
+	return ops->tune_rate(map, reg);
 }
 
 int
@@ -14,6 +14,11 @@ struct regmap_driver_ops {
 	int (*prepare)(const struct regmap *map);
 	int (*read)(const struct regmap *map, uint8_t reg, uint8_t *val);
 	int (*write)(const struct regmap *map, uint8_t reg, uint8_t val);
+	int (*read_bulk)(const struct regmap *map, uint8_t reg, uint8_t *vals,
+	                 uint8_t count);
+	int (*write_bulk)(const struct regmap *map, uint8_t reg,
+	                  const uint8_t *vals, uint8_t count);
+	int (*tune_rate)(const struct regmap *map, uint8_t reg);
 };
 
 struct regmap_driver {
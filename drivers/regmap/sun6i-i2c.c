@@ -3,11 +3,12 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
-#include <delay.h>
 #include <error.h>
 #include <mmio.h>
 #include <regmap.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <timeout.h>
 #include <util.h>
 #include <clock/ccu.h>
 #include <gpio/sunxi-gpio.h>
@@ -40,16 +41,21 @@ enum {
 	IDLE                 = 0xf8,
 };
 
+/* The length of one bus clock cycle, in microseconds. */
+#define I2C_CYCLE_US      ((USEC_PER_SEC + CONFIG_I2C_RATE - 1) / \
+                           CONFIG_I2C_RATE)
+
+/* Allow some slack for register access latency and clock stretching. */
+#define I2C_TIMEOUT(cyc)  ((cyc) * I2C_CYCLE_US + 10)
+
 static int
 sun6i_i2c_wait_idle(const struct simple_device *self)
 {
 	/* With a single master on the bus, this should only take one cycle. */
-	int timeout = 2;
+	uint32_t timeout = timeout_set(I2C_TIMEOUT(2));
 
 	while (mmio_read_32(self->regs + I2C_CTRL_REG) & (BIT(5) | BIT(4))) {
-		/* 10μs is one 100kHz bus cycle. */
-		udelay(10);
-		if (timeout-- == 0)
+		if (timeout_expired(timeout))
 			return EIO;
 	}
 
@@ -63,12 +69,10 @@ static int
 sun6i_i2c_wait_start(const struct simple_device *self)
 {
 	/* With a single master on the bus, this should only take one cycle. */
-	int timeout = 2;
+	uint32_t timeout = timeout_set(I2C_TIMEOUT(2));
 
 	while (mmio_read_32(self->regs + I2C_CTRL_REG) & BIT(5)) {
-		/* 10μs is one 100kHz bus cycle. */
-		udelay(10);
-		if (timeout-- == 0)
+		if (timeout_expired(timeout))
 			return EIO;
 	}
 
@@ -79,12 +83,11 @@ static int
 sun6i_i2c_wait_state(const struct simple_device *self, uint8_t state)
 {
 	/* Wait for up to 8 transfer cycles, one ACK, and one extra cycle. */
-	int timeout = 10;
+	uint32_t timeout = timeout_set(I2C_TIMEOUT(10));
 
+	/* The interrupt flag is set as soon as the state machine stops. */
 	while (!(mmio_read_32(self->regs + I2C_CTRL_REG) & BIT(3))) {
-		/* 10μs is one 100kHz bus cycle. */
-		udelay(10);
-		if (timeout-- == 0)
+		if (timeout_expired(timeout))
 			return EIO;
 	}
 
@@ -95,16 +98,21 @@ sun6i_i2c_wait_state(const struct simple_device *self, uint8_t state)
 }
 
 static int
-sun6i_i2c_read(const struct regmap *map, uint8_t *data)
+sun6i_i2c_read(const struct regmap *map, uint8_t *data, bool ack)
 {
 	const struct simple_device *self = to_simple_device(map->dev);
+	uint8_t state = ack ? DATA_RX_ACK : DATA_RX_NACK;
 	int err;
 
-	/* Disable sending an ACK and trigger a state change. */
-	mmio_clrset_32(self->regs + I2C_CTRL_REG, BIT(2), BIT(3));
+	/* ACK the byte if more are expected in a burst; otherwise, NACK it.
+	 * Then trigger a state change. */
+	if (ack)
+		mmio_set_32(self->regs + I2C_CTRL_REG, BIT(3) | BIT(2));
+	else
+		mmio_clrset_32(self->regs + I2C_CTRL_REG, BIT(2), BIT(3));
 
 	/* Wait for data to arrive. */
-	if ((err = sun6i_i2c_wait_state(self, DATA_RX_NACK)))
+	if ((err = sun6i_i2c_wait_state(self, state)))
 		return err;
 
 	/* Read the data. */
@@ -175,6 +183,35 @@ sun6i_i2c_write(const struct regmap *map, uint8_t data)
 	return SUCCESS;
 }
 
+/**
+ * Program the clock divider for the fastest rate not exceeding the target.
+ *
+ * The bus clock is F_scl = F_in / (10 * (M + 1) * 2^N).
+ */
+static void
+sun6i_i2c_set_rate(const struct simple_device *self, uint32_t rate)
+{
+	uint32_t parent  = clock_get_rate(&self->clock);
+	uint32_t divider = parent / (10 * rate);
+	uint32_t m, n;
+
+	/* Round up, so the resulting rate is never too fast. */
+	if (divider * 10 * rate < parent)
+		++divider;
+
+	/* Use the smallest prescaler that lets M fit in its 4-bit field. */
+	n = 0;
+	while (n < 7 && (divider + BIT(n) - 1) >> n > 16)
+		++n;
+	m = (divider + BIT(n) - 1) >> n;
+	if (m > 16)
+		m = 16;
+	if (m > 0)
+		m = m - 1;
+
+	mmio_write_32(self->regs + I2C_CCR_REG, m << 3 | n);
+}
+
 static int
 sun6i_i2c_probe(const struct device *dev)
 {
@@ -184,8 +221,8 @@ sun6i_i2c_probe(const struct device *dev)
 	if ((err = simple_device_probe(dev)))
 		return err;
 
-	/* Set I2C bus clock divider for 400 KHz operation. */
-	mmio_write_32(self->regs + I2C_CCR_REG, 0x00000011);
+	/* Set the I2C bus clock divider for the configured rate. */
+	sun6i_i2c_set_rate(self, CONFIG_I2C_RATE);
 
 	/* Clear slave address (this driver only supports master mode). */
 	mmio_write_32(self->regs + I2C_ADDR_REG, 0);
@@ -217,9 +254,11 @@ static const struct regmap_i2c_driver sun6i_i2c_driver = {
 			.release = simple_device_release,
 		},
 		.ops = {
-			.prepare = regmap_i2c_prepare,
-			.read    = regmap_i2c_read,
-			.write   = regmap_i2c_write,
+			.prepare    = regmap_i2c_prepare,
+			.read       = regmap_i2c_read,
+			.write      = regmap_i2c_write,
+			.read_bulk  = regmap_i2c_read_bulk,
+			.write_bulk = regmap_i2c_write_bulk,
 		},
 	},
 	.ops = {
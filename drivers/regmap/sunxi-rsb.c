@@ -3,8 +3,11 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <debug.h>
 #include <error.h>
 #include <mmio.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <util.h>
 #include <clock/ccu.h>
 #include <gpio/sunxi-gpio.h>
@@ -30,6 +33,11 @@
 #define PMIC_MODE_REG  0x3e
 #define PMIC_MODE_VAL  0x7c
 
+#define RSB_SAFE_RATE  3000000
+
+/* Each candidate rate must survive this many reads before it is used. */
+#define RSB_TUNE_READS 8
+
 enum {
 	RSB_SRTA = 0xe8,
 	RSB_RD8  = 0x8b,
@@ -40,11 +48,52 @@ enum {
 	RSB_WR32 = 0x63,
 };
 
-static int
-sunxi_rsb_do_command(const struct regmap *map, uint32_t cmd)
+static const uint32_t rsb_tune_rates[] = {
+	6000000,
+	12000000,
+	20000000,
+};
+
+/* The validated bus rate, as actually produced by the divider. This is kept
+ * across suspend/resume. */
+static uint32_t rsb_rate;
+
+/* The requested rate and the parent clock rate used to program the divider. */
+static uint32_t rsb_target;
+static uint32_t rsb_parent_rate;
+
+/* Set while trying out rates, so failures are not treated as fatal. */
+static bool rsb_tuning;
+
+/**
+ * Program the bus clock divider so the bus runs as fast as possible without
+ * exceeding the requested rate.
+ *
+ * @return The resulting bus clock rate.
+ */
+static uint32_t
+sunxi_rsb_set_rate(const struct simple_device *self, uint32_t rate)
 {
-	const struct simple_device *self = to_simple_device(map->dev);
+	uint32_t parent  = clock_get_rate(&self->clock);
+	uint32_t divider = (parent + 2 * rate - 1) / (2 * rate);
+
+	if (divider > 0)
+		divider = divider - 1;
+	if (divider > 0xff)
+		divider = 0xff;
+
+	mmio_write_32(self->regs + RSB_CCR_REG, 1U << 8 | divider);
 
+	rsb_target      = rate;
+	rsb_parent_rate = parent;
+
+	return parent / (2 * (divider + 1));
+}
+
+static int
+sunxi_rsb_send_command(const struct simple_device *self,
+                       const struct regmap *map, uint32_t cmd)
+{
 	mmio_write_32(self->regs + RSB_CMD_REG, cmd);
 	mmio_write_32(self->regs + RSB_SADDR_REG, map->id);
 	mmio_write_32(self->regs + RSB_CTRL_REG, BIT(7));
@@ -55,6 +104,31 @@ sunxi_rsb_do_command(const struct regmap *map, uint32_t cmd)
 	       ? SUCCESS : EIO;
 }
 
+static int
+sunxi_rsb_do_command(const struct regmap *map, uint32_t cmd)
+{
+	const struct simple_device *self = to_simple_device(map->dev);
+	int err;
+
+	/* Boosting the CPU clock also changes APB0, the RSB parent clock. */
+	if (clock_get_rate(&self->clock) != rsb_parent_rate)
+		sunxi_rsb_set_rate(self, rsb_target);
+
+	err = sunxi_rsb_send_command(self, map, cmd);
+
+	/* If a raised rate stops working, drop back to the safe rate for
+	 * good, and retry the command once. The address and data registers
+	 * still hold their values from the failed attempt. */
+	if (err && !rsb_tuning && rsb_rate > RSB_SAFE_RATE) {
+		warn("RSB: Falling back to %u Hz", RSB_SAFE_RATE);
+		rsb_rate = RSB_SAFE_RATE;
+		sunxi_rsb_set_rate(self, rsb_rate);
+		err = sunxi_rsb_send_command(self, map, cmd);
+	}
+
+	return err;
+}
+
 static int
 sunxi_rsb_prepare(const struct regmap *map)
 {
@@ -89,17 +163,121 @@ sunxi_rsb_write(const struct regmap *map, uint8_t addr, uint8_t data)
 	return sunxi_rsb_do_command(map, RSB_WR8);
 }
 
-static void
-sunxi_rsb_set_rate(const struct simple_device *self, uint32_t rate)
+/**
+ * Select the widest command that transfers at most count bytes.
+ *
+ * The 16 and 32-bit commands move several bytes in one frame, starting at the
+ * register in RSB_ADDR_REG. The controller packs them into RSB_DATA_REG in
+ * transfer order, starting at the least significant byte. Mapping the bytes
+ * to consecutive registers relies on the device incrementing the register
+ * address after each byte, as AXP PMICs do for I2C bursts. Devices that do
+ * not must not use the bulk accessors.
+ */
+static uint8_t
+sunxi_rsb_width(uint8_t count)
 {
-	uint32_t divider = (clock_get_rate(&self->clock) + rate) / (2 * rate);
+	return count >= 4 ? 4 : count >= 2 ? 2 : 1;
+}
 
-	if (divider > 0)
-		divider = divider - 1;
-	if (divider > 0xff)
-		divider = 0xff;
+static int
+sunxi_rsb_read_bulk(const struct regmap *map, uint8_t addr, uint8_t *data,
+                    uint8_t count)
+{
+	static const uint8_t read_cmds[] = {
+		[1] = RSB_RD8, [2] = RSB_RD16, [4] = RSB_RD32,
+	};
+	const struct simple_device *self = to_simple_device(map->dev);
+	int err;
 
-	mmio_write_32(self->regs + RSB_CCR_REG, 1U << 8 | divider);
+	while (count) {
+		uint8_t width = sunxi_rsb_width(count);
+		uint32_t val;
+
+		mmio_write_32(self->regs + RSB_ADDR_REG, addr);
+
+		if ((err = sunxi_rsb_do_command(map, read_cmds[width])))
+			return err;
+
+		/* The first register is in the least significant byte. */
+		val = mmio_read_32(self->regs + RSB_DATA_REG);
+		for (uint8_t i = 0; i < width; ++i, val >>= 8)
+			*data++ = val;
+
+		addr  += width;
+		count -= width;
+	}
+
+	return SUCCESS;
+}
+
+static int
+sunxi_rsb_write_bulk(const struct regmap *map, uint8_t addr,
+                     const uint8_t *data, uint8_t count)
+{
+	static const uint8_t write_cmds[] = {
+		[1] = RSB_WR8, [2] = RSB_WR16, [4] = RSB_WR32,
+	};
+	const struct simple_device *self = to_simple_device(map->dev);
+	int err;
+
+	while (count) {
+		uint8_t width = sunxi_rsb_width(count);
+		uint32_t val = 0;
+
+		/* The first register is in the least significant byte. */
+		for (uint8_t i = 0; i < width; ++i)
+			val |= (uint32_t)*data++ << (8 * i);
+
+		mmio_write_32(self->regs + RSB_ADDR_REG, addr);
+		mmio_write_32(self->regs + RSB_DATA_REG, val);
+
+		if ((err = sunxi_rsb_do_command(map, write_cmds[width])))
+			return err;
+
+		addr  += width;
+		count -= width;
+	}
+
+	return SUCCESS;
+}
+
+static int
+sunxi_rsb_tune_rate(const struct regmap *map, uint8_t reg)
+{
+	const struct simple_device *self = to_simple_device(map->dev);
+	uint32_t good = RSB_SAFE_RATE;
+	uint8_t expected, val;
+	int err;
+
+	/* Only tune once; later calls keep the remembered rate. */
+	if (rsb_rate)
+		return SUCCESS;
+
+	/* Get a reference value at the safe rate. */
+	if ((err = sunxi_rsb_read(map, reg, &expected)))
+		return err;
+
+	rsb_tuning = true;
+	for (uint8_t i = 0; i < ARRAY_SIZE(rsb_tune_rates); ++i) {
+		uint32_t rate = rsb_tune_rates[i];
+
+		if (rate > CONFIG_RSB_MAX_RATE)
+			break;
+		rate = sunxi_rsb_set_rate(self, rate);
+		for (uint8_t j = 0; j < RSB_TUNE_READS; ++j) {
+			if (sunxi_rsb_read(map, reg, &val) || val != expected)
+				goto done;
+		}
+		good = rate;
+	}
+done:
+	rsb_tuning = false;
+
+	rsb_rate = good;
+	sunxi_rsb_set_rate(self, rsb_rate);
+	debug("RSB: Using %u Hz", rsb_rate);
+
+	return SUCCESS;
 }
 
 static int
@@ -116,13 +294,17 @@ sunxi_rsb_probe(const struct device *dev)
 	mmio_pollz_32(self->regs + RSB_CTRL_REG, BIT(0));
 
 	/* Set the bus clock rate to its default value (3 MHz). */
-	sunxi_rsb_set_rate(self, 3000000);
+	sunxi_rsb_set_rate(self, RSB_SAFE_RATE);
 
 	/* Switch all devices to RSB mode. */
 	mmio_write_32(self->regs + RSB_PMCR_REG, I2C_BCAST_ADDR |
 	              PMIC_MODE_REG << 8 | PMIC_MODE_VAL << 16 | BIT(31));
 	mmio_pollz_32(self->regs + RSB_PMCR_REG, BIT(31));
 
+	/* Go back to the rate validated before the controller was released. */
+	if (rsb_rate)
+		sunxi_rsb_set_rate(self, rsb_rate);
+
 	return SUCCESS;
 }
 
@@ -132,9 +314,12 @@ static const struct regmap_driver sunxi_rsb_driver = {
 		.release = simple_device_release,
 	},
 	.ops = {
-		.prepare = sunxi_rsb_prepare,
-		.read    = sunxi_rsb_read,
-		.write   = sunxi_rsb_write,
+		.prepare    = sunxi_rsb_prepare,
+		.read       = sunxi_rsb_read,
+		.write      = sunxi_rsb_write,
+		.read_bulk  = sunxi_rsb_read_bulk,
+		.write_bulk = sunxi_rsb_write_bulk,
+		.tune_rate  = sunxi_rsb_tune_rate,
 	},
 };
 
@@ -5,9 +5,33 @@
 
 #include <error.h>
 #include <regmap.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
 
 #include "axp20x.h"
 
+/* The enable bits for all regulators fit in this many adjacent registers. */
+#define MAX_ENABLE_REGS 4
+
+/* Settings saved while regulators are in their low-power state. There is only
+ * ever one AXP PMIC, so this does not need to be per-device. */
+struct axp20x_retention_state {
+	uint8_t voltage[AXP20X_MAX_RETENTION];
+	uint8_t pwm;
+	uint8_t retained;
+};
+
+#if CONFIG(REGULATOR_RETENTION)
+/* This variable is persisted across exception restarts, so the settings can
+ * still be restored if the firmware crashes while the system is asleep. Its
+ * size is accounted for in the linker script. */
+static struct axp20x_retention_state saved
+ATTRIBUTE(section(".data.axp20x_retention"));
+#else
+static struct axp20x_retention_state saved;
+#endif
+
 static int
 axp20x_regulator_get_state(const struct regulator_handle *handle,
                            bool *enabled)
@@ -36,6 +60,188 @@ axp20x_regulator_set_state(const struct regulator_handle *handle, bool enabled)
 	return regmap_update_bits(self->map, addr, mask, enabled ? mask : 0);
 }
 
+static int
+axp20x_regulator_set_bulk_state(const struct device *dev,
+                                const struct regulator_handle *const *handles,
+                                uint8_t count, bool enabled)
+{
+	const struct axp20x_regulator *self = to_axp20x_regulator(dev);
+	uint8_t masks[MAX_ENABLE_REGS] = { 0 };
+	uint8_t old[MAX_ENABLE_REGS], new[MAX_ENABLE_REGS];
+	uint8_t first = UINT8_MAX, last = 0, span;
+	int err;
+
+	/* Find the range of enable registers used by this supplier. */
+	for (uint8_t i = 0; i < count; ++i) {
+		uint8_t addr;
+
+		if (handles[i]->dev != dev)
+			continue;
+		addr = self->info[handles[i]->id].enable_register;
+		if (addr < first)
+			first = addr;
+		if (addr > last)
+			last = addr;
+	}
+	if (first > last)
+		return SUCCESS;
+	span = last - first + 1;
+	if (span > MAX_ENABLE_REGS) {
+		for (uint8_t i = 0; i < count; ++i) {
+			if (handles[i]->dev != dev)
+				continue;
+			if ((err = axp20x_regulator_set_state(handles[i],
+			                                      enabled)))
+				return err;
+		}
+		return SUCCESS;
+	}
+
+	for (uint8_t i = 0; i < count; ++i) {
+		const struct axp20x_regulator_info *info;
+
+		if (handles[i]->dev != dev)
+			continue;
+		info = &self->info[handles[i]->id];
+		masks[info->enable_register - first] |= info->enable_mask;
+	}
+
+	/* Read the whole bank at once, then only write what changed. */
+	if ((err = regmap_read_bulk(self->map, first, old, span)))
+		return err;
+	for (uint8_t i = 0; i < span; ++i)
+		new[i] = enabled ? old[i] | masks[i] : old[i] & ~masks[i];
+
+	/* Write each run of changed registers in one transfer. */
+	for (uint8_t i = 0; i < span; ++i) {
+		uint8_t n = 0;
+
+		while (i + n < span && new[i + n] != old[i + n])
+			++n;
+		if (n == 0)
+			continue;
+		if ((err = regmap_write_bulk(self->map, first + i,
+		                             &new[i], n)))
+			return err;
+		i += n;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Find the retention table entry for a regulator.
+ *
+ * @return The index of the entry, or -1 if there is none.
+ */
+static int
+axp20x_retention_index(const struct axp20x_regulator *self, uint8_t id)
+{
+	for (uint8_t i = 0; i < self->retention_count; ++i) {
+		if (self->retention[i].id == id)
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Find the lowest voltage selector that provides at least the given voltage.
+ */
+static uint8_t
+axp20x_voltage_selector(const struct axp20x_retention_info *info, uint16_t mV)
+{
+	uint8_t first = 0;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(info->ranges); ++i) {
+		const struct axp20x_voltage_range *range = &info->ranges[i];
+		uint32_t step = range->step_mV;
+
+		if (!step)
+			break;
+		if (mV <= range->min_mV)
+			return first;
+		if (mV <= range->min_mV + step * (range->max_sel - first))
+			return first + (mV - range->min_mV + step - 1) / step;
+		first = range->max_sel + 1;
+	}
+
+	/* The voltage is out of range; use the highest selector. */
+	return first - 1;
+}
+
+static int
+axp20x_regulator_enter_retention(const struct regulator_handle *handle,
+                                 uint16_t mV)
+{
+	const struct axp20x_regulator *self = to_axp20x_regulator(handle->dev);
+	const struct axp20x_retention_info *info;
+	int index = axp20x_retention_index(self, handle->id);
+	uint8_t mode, sel, val;
+	int err;
+
+	if (index < 0)
+		return ENOTSUP;
+	if (saved.retained & BIT(index))
+		return SUCCESS;
+	info = &self->retention[index];
+
+	if ((err = regmap_read(self->map, info->voltage_register, &val)))
+		return err;
+	if ((err = regmap_read(self->map, info->mode_register, &mode)))
+		return err;
+
+	saved.voltage[index] = val & info->voltage_mask;
+	if (mode & info->mode_mask)
+		saved.pwm |= BIT(index);
+	else
+		saved.pwm &= ~BIT(index);
+	saved.retained |= BIT(index);
+
+	/* Lower the voltage first, while the regulator is still in PWM mode
+	 * and can respond quickly to the change. Never raise the voltage. */
+	if (mV) {
+		sel = axp20x_voltage_selector(info, mV);
+		if (sel < saved.voltage[index] &&
+		    (err = regmap_update_bits(self->map, info->voltage_register,
+		                              info->voltage_mask, sel)))
+			return err;
+	}
+
+	/* Allow automatic PFM operation at light loads. */
+	return regmap_clr_bits(self->map, info->mode_register, info->mode_mask);
+}
+
+static int
+axp20x_regulator_exit_retention(const struct regulator_handle *handle)
+{
+	const struct axp20x_regulator *self = to_axp20x_regulator(handle->dev);
+	const struct axp20x_retention_info *info;
+	int index = axp20x_retention_index(self, handle->id);
+	int err;
+
+	if (index < 0)
+		return ENOTSUP;
+	if (!(saved.retained & BIT(index)))
+		return SUCCESS;
+	info = &self->retention[index];
+
+	/* Restore the mode first, so the regulator can supply the load
+	 * transient when the voltage rises. */
+	if (saved.pwm & BIT(index) &&
+	    (err = regmap_set_bits(self->map, info->mode_register,
+	                           info->mode_mask)))
+		return err;
+	if ((err = regmap_update_bits(self->map, info->voltage_register,
+	                              info->voltage_mask,
+	                              saved.voltage[index])))
+		return err;
+
+	saved.retained &= ~BIT(index);
+
+	return SUCCESS;
+}
+
 static int
 axp20x_regulator_probe(const struct device *dev)
 {
@@ -58,7 +264,10 @@ const struct regulator_driver axp20x_regulator_driver = {
 		.release = axp20x_regulator_release,
 	},
 	.ops = {
-		.get_state = axp20x_regulator_get_state,
-		.set_state = axp20x_regulator_set_state,
+		.get_state       = axp20x_regulator_get_state,
+		.set_state       = axp20x_regulator_set_state,
+		.set_bulk_state  = axp20x_regulator_set_bulk_state,
+		.enter_retention = axp20x_regulator_enter_retention,
+		.exit_retention  = axp20x_regulator_exit_retention,
 	},
 };
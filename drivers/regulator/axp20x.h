@@ -17,6 +17,27 @@ struct axp20x_regulator_info {
 	uint8_t enable_mask;
 };
 
+struct axp20x_voltage_range {
+	uint16_t min_mV;  /**< Voltage at the first selector in the range. */
+	uint8_t  step_mV; /**< Voltage step; zero if the range is unused. */
+	uint8_t  max_sel; /**< Last selector in the range. */
+};
+
+/**
+ * Description of a regulator that has a low-power state for suspend.
+ */
+struct axp20x_retention_info {
+	uint8_t                     id;
+	uint8_t                     voltage_register;
+	uint8_t                     voltage_mask;
+	uint8_t                     mode_register; /**< Has the PWM bit. */
+	uint8_t                     mode_mask;     /**< Set forces PWM. */
+	struct axp20x_voltage_range ranges[2];
+};
+
+/* The maximum number of entries in a retention table. */
+#define AXP20X_MAX_RETENTION 8
+
 extern const struct regulator_driver axp20x_regulator_driver;
 
 static inline const struct axp20x_regulator *
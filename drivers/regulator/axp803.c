@@ -13,6 +13,9 @@
 #define OUTPUT_POWER_CONTROL1 0x10
 #define OUTPUT_POWER_CONTROL2 0x12
 #define OUTPUT_POWER_CONTROL3 0x13
+#define DCDC5_VOLTAGE_CONTROL 0x24
+#define DCDC6_VOLTAGE_CONTROL 0x25
+#define DCDC_MODE_CONTROL     0x80
 
 static const struct axp20x_regulator_info axp803_regulators[] = {
 	[AXP803_REGL_DCDC1] = {
@@ -93,12 +96,43 @@ static const struct axp20x_regulator_info axp803_regulators[] = {
 	},
 };
 
+/* DCDC5 (VCC-DRAM) and DCDC6 (VDD-SYS) stay on during suspend. */
+static const struct axp20x_retention_info axp803_retention[] = {
+	{
+		.id               = AXP803_REGL_DCDC5,
+		.voltage_register = DCDC5_VOLTAGE_CONTROL,
+		.voltage_mask     = 0x7f,
+		.mode_register    = DCDC_MODE_CONTROL,
+		.mode_mask        = BIT(4),
+		.ranges           = {
+			{ .min_mV = 800, .step_mV = 10, .max_sel = 0x20 },
+			{ .min_mV = 1140, .step_mV = 20, .max_sel = 0x44 },
+		},
+	},
+	{
+		.id               = AXP803_REGL_DCDC6,
+		.voltage_register = DCDC6_VOLTAGE_CONTROL,
+		.voltage_mask     = 0x7f,
+		.mode_register    = DCDC_MODE_CONTROL,
+		.mode_mask        = BIT(5),
+		.ranges           = {
+			{ .min_mV = 600, .step_mV = 10, .max_sel = 0x32 },
+			{ .min_mV = 1120, .step_mV = 20, .max_sel = 0x47 },
+		},
+	},
+};
+
+static_assert(ARRAY_SIZE(axp803_retention) <= AXP20X_MAX_RETENTION,
+              "Too many entries in the retention table");
+
 const struct axp20x_regulator axp803_regulator = {
 	.dev = {
 		.name  = "axp803-regulator",
 		.drv   = &axp20x_regulator_driver.drv,
 		.state = DEVICE_STATE_INIT,
 	},
-	.map  = &axp20x.map,
-	.info = axp803_regulators,
+	.map             = &axp20x.map,
+	.info            = axp803_regulators,
+	.retention       = axp803_retention,
+	.retention_count = ARRAY_SIZE(axp803_retention),
 };
@@ -12,6 +12,9 @@
 
 #define POWER_ONOFF_CTRL_REG1 0x10
 #define POWER_ONOFF_CTRL_REG2 0x11
+#define DCDCD_VOLTAGE_CTRL    0x15
+#define DCDCE_VOLTAGE_CTRL    0x16
+#define DCDC_MODE_CTRL_REG2   0x1b
 
 static const struct axp20x_regulator_info axp805_regulators[] = {
 	[AXP805_REGL_DCDCA] = {
@@ -80,12 +83,42 @@ static const struct axp20x_regulator_info axp805_regulators[] = {
 	},
 };
 
+/* DCDCD (VDD-SYS) and DCDCE (VCC-DRAM) stay on during suspend. */
+static const struct axp20x_retention_info axp805_retention[] = {
+	{
+		.id               = AXP805_REGL_DCDCD,
+		.voltage_register = DCDCD_VOLTAGE_CTRL,
+		.voltage_mask     = 0x3f,
+		.mode_register    = DCDC_MODE_CTRL_REG2,
+		.mode_mask        = BIT(3),
+		.ranges           = {
+			{ .min_mV = 600, .step_mV = 20, .max_sel = 0x2d },
+			{ .min_mV = 1600, .step_mV = 100, .max_sel = 0x3f },
+		},
+	},
+	{
+		.id               = AXP805_REGL_DCDCE,
+		.voltage_register = DCDCE_VOLTAGE_CTRL,
+		.voltage_mask     = 0x1f,
+		.mode_register    = DCDC_MODE_CTRL_REG2,
+		.mode_mask        = BIT(4),
+		.ranges           = {
+			{ .min_mV = 1100, .step_mV = 100, .max_sel = 0x17 },
+		},
+	},
+};
+
+static_assert(ARRAY_SIZE(axp805_retention) <= AXP20X_MAX_RETENTION,
+              "Too many entries in the retention table");
+
 const struct axp20x_regulator axp805_regulator = {
 	.dev = {
 		.name  = "axp805-regulator",
 		.drv   = &axp20x_regulator_driver.drv,
 		.state = DEVICE_STATE_INIT,
 	},
-	.map  = &axp20x.map,
-	.info = axp805_regulators,
+	.map             = &axp20x.map,
+	.info            = axp805_regulators,
+	.retention       = axp805_retention,
+	.retention_count = ARRAY_SIZE(axp805_retention),
 };
@@ -9,6 +9,7 @@
 #include <regulator.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <util.h>
 
 #include "regulator.h"
 
@@ -39,6 +40,61 @@ regulator_set_state(const struct regulator_handle *handle, bool enable)
 	return err;
 }
 
+static int
+regulator_bulk_set_state(const struct regulator_handle *const *handles,
+                         uint8_t count, bool enable)
+{
+	uint32_t done = 0;
+	int err, ret = SUCCESS;
+
+	for (uint8_t i = 0; i < count; ++i) {
+		const struct device *dev = handles[i]->dev;
+		const struct regulator_driver_ops *ops;
+
+		if (done & BIT(i))
+			continue;
+
+		/* Mark every regulator from this supplier as handled. */
+		for (uint8_t j = i; j < count; ++j) {
+			if (handles[j]->dev == dev)
+				done |= BIT(j);
+		}
+
+		if ((err = device_get(dev))) {
+			if (!ret)
+				ret = err;
+			continue;
+		}
+
+		ops = regulator_ops_for(dev);
+		if (ops->set_bulk_state) {
+			err = ops->set_bulk_state(dev, &handles[i], count - i,
+			                          enable);
+			if (err && !ret)
+				ret = err;
+		} else {
+			for (uint8_t j = i; j < count; ++j) {
+				if (handles[j]->dev != dev)
+					continue;
+				err = ops->set_state(handles[j], enable);
+				if (err && !ret)
+					ret = err;
+			}
+		}
+
+		device_put(dev);
+	}
+
+	return ret;
+}
+
+int
+regulator_bulk_disable(const struct regulator_handle *const *handles,
+                       uint8_t count)
+{
+	return regulator_bulk_set_state(handles, count, false);
+}
+
 int
 regulator_disable(const struct regulator_handle *handle)
 {
@@ -65,3 +121,37 @@ regulator_get_state(const struct regulator_handle *handle, bool *enabled)
 
 	return err;
 }
+
+int
+regulator_enter_retention(const struct regulator_handle *handle, uint16_t mV)
+{
+	const struct regulator_driver_ops *ops;
+	int err;
+
+	if ((err = device_get(handle->dev)))
+		return err;
+
+	ops = regulator_ops_for(handle->dev);
+	err = ops->enter_retention ? ops->enter_retention(handle, mV) : ENOTSUP;
+
+	device_put(handle->dev);
+
+	return err;
+}
+
+int
+regulator_exit_retention(const struct regulator_handle *handle)
+{
+	const struct regulator_driver_ops *ops;
+	int err;
+
+	if ((err = device_get(handle->dev)))
+		return err;
+
+	ops = regulator_ops_for(handle->dev);
+	err = ops->exit_retention ? ops->exit_retention(handle) : ENOTSUP;
+
+	device_put(handle->dev);
+
+	return err;
+}
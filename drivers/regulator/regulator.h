@@ -13,6 +13,12 @@
 struct regulator_driver_ops {
 	int (*get_state)(const struct regulator_handle *handle, bool *enabled);
 	int (*set_state)(const struct regulator_handle *handle, bool enable);
+	int (*set_bulk_state)(const struct device *dev,
+	                      const struct regulator_handle *const *handles,
+	                      uint8_t count, bool enable);
+	int (*enter_retention)(const struct regulator_handle *handle,
+	                       uint16_t mV);
+	int (*exit_retention)(const struct regulator_handle *handle);
 };
 
 struct regulator_driver {
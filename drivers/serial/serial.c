@@ -3,11 +3,139 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <debug.h>
 #include <mmio.h>
 #include <serial.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #include "uart.h"
 
+#if CONFIG(SERIAL_TX_BUFFER)
+
+#define TX_BUFFER_SIZE CONFIG_SERIAL_TX_BUFFER_SIZE
+
+static_assert((TX_BUFFER_SIZE & (TX_BUFFER_SIZE - 1)) == 0,
+              "TX buffer size must be a power of two");
+
+/* The indexes are free-running; the buffer is empty when they are equal. */
+static char     tx_buffer[TX_BUFFER_SIZE];
+static uint32_t tx_dropped;
+static uint32_t tx_head;
+static uint32_t tx_tail;
+/* Set while flushing from the exception entry path. */
+static bool     tx_rescuing;
+
+/**
+ * Move characters from the buffer to the UART FIFO until either is empty/full.
+ *
+ * @return Whether or not the buffer is now empty.
+ */
+static bool
+serial_drain(void)
+{
+	while (tx_tail != tx_head) {
+		if (!mmio_get_32(uart.regs + UART_USR, UART_USR_TFNF))
+			return false;
+		mmio_write_32(uart.regs + UART_THR,
+		              tx_buffer[tx_tail++ % TX_BUFFER_SIZE]);
+	}
+
+	return true;
+}
+
+static void
+serial_tx(char c)
+{
+	while (tx_head - tx_tail == TX_BUFFER_SIZE) {
+		if (CONFIG(SERIAL_TX_OVERFLOW_DROP)) {
+			++tx_dropped;
+			return;
+		}
+		serial_drain();
+	}
+	tx_buffer[tx_head++ % TX_BUFFER_SIZE] = c;
+}
+
+void
+serial_write(const uint8_t *data, uint32_t size)
+{
+	/* Drop all of the data or none of it. */
+	if (CONFIG(SERIAL_TX_OVERFLOW_DROP) &&
+	    TX_BUFFER_SIZE - (tx_head - tx_tail) < size) {
+		tx_dropped += size;
+		return;
+	}
+	while (size--)
+		serial_tx(*data++);
+}
+
+void
+serial_poll(void)
+{
+	uint32_t dropped;
+
+	if (tx_tail == tx_head && !tx_dropped)
+		return;
+	if (!serial_ready() || !serial_drain() || !tx_dropped)
+		return;
+
+	/* Clear the count first, in case this message is also dropped. */
+	dropped = tx_dropped, tx_dropped = 0;
+	warn("Dropped %u bytes of serial output", dropped);
+}
+
+void
+serial_rescue(void)
+{
+	/* Give up if the last attempt caused another exception. */
+	if (tx_rescuing)
+		return;
+	tx_rescuing = true;
+	serial_flush();
+}
+
+#else
+
+static bool
+serial_drain(void)
+{
+	return true;
+}
+
+static void
+serial_tx(char c)
+{
+	mmio_poll_32(uart.regs + UART_LSR, UART_LSR_THRE);
+	mmio_write_32(uart.regs + UART_THR, c);
+}
+
+void
+serial_write(const uint8_t *data, uint32_t size)
+{
+	while (size--)
+		serial_tx(*data++);
+}
+
+void
+serial_poll(void)
+{
+}
+
+#endif
+
+void
+serial_flush(void)
+{
+	if (!serial_ready())
+		return;
+
+	while (!serial_drain()) {
+		/* Wait for space in the FIFO. */
+	}
+	mmio_poll_32(uart.regs + UART_LSR, UART_LSR_TEMT);
+}
+
 char
 serial_getc(void)
 {
@@ -22,8 +150,7 @@ serial_putc(char c)
 {
 	if (c == '\n')
 		serial_putc('\r');
-	mmio_poll_32(uart.regs + UART_LSR, UART_LSR_THRE);
-	mmio_write_32(uart.regs + UART_THR, c);
+	serial_tx(c);
 }
 
 void
@@ -41,6 +168,13 @@ serial_init(void)
 	device_get(&uart.dev);
 }
 
+void
+serial_update_rate(void)
+{
+	if (CONFIG_SERIAL_BAUD && device_active(&uart.dev))
+		uart_set_divisor(&uart);
+}
+
 bool
 serial_ready(void)
 {
@@ -9,6 +9,22 @@
 
 #include "uart.h"
 
+void
+uart_set_divisor(const struct simple_device *self)
+{
+	uint32_t  rate    = clock_get_rate(&self->clock);
+	uint32_t  divisor = udiv_round(rate, 16 * CONFIG_SERIAL_BAUD);
+	uintptr_t regs    = self->regs;
+
+	/* Set the clock divisor. */
+	mmio_write_32(regs + UART_LCR, UART_LCR_DLAB);
+	mmio_write_32(regs + UART_DLH, divisor >> 8);
+	mmio_write_32(regs + UART_DLL, divisor);
+
+	/* Set the UART to 8 data bits, no parity, 1 stop bit. */
+	mmio_write_32(regs + UART_LCR, UART_LCR_DLS8);
+}
+
 static int
 uart_probe(const struct device *dev)
 {
@@ -19,20 +35,10 @@ uart_probe(const struct device *dev)
 		return err;
 
 	if (CONFIG_SERIAL_BAUD) {
-		uint32_t  rate    = clock_get_rate(&self->clock);
-		uint32_t  divisor = udiv_round(rate, 16 * CONFIG_SERIAL_BAUD);
-		uintptr_t regs    = self->regs;
-
-		/* Set the clock divisor. */
-		mmio_write_32(regs + UART_LCR, UART_LCR_DLAB);
-		mmio_write_32(regs + UART_DLH, divisor >> 8);
-		mmio_write_32(regs + UART_DLL, divisor);
-
-		/* Set the UART to 8 data bits, no parity, 1 stop bit. */
-		mmio_write_32(regs + UART_LCR, UART_LCR_DLS8);
+		uart_set_divisor(self);
 
 		/* Enable the FIFOs. */
-		mmio_write_32(regs + UART_FCR, UART_FCR_FIFOE);
+		mmio_write_32(self->regs + UART_FCR, UART_FCR_FIFOE);
 	}
 
 	return SUCCESS;
@@ -17,6 +17,7 @@ enum {
 	UART_FCR = 0x0008,
 	UART_LCR = 0x000c,
 	UART_LSR = 0x0014,
+	UART_USR = 0x007c,
 };
 
 enum {
@@ -31,9 +32,19 @@ enum {
 enum {
 	UART_LSR_DR   = BIT(0),
 	UART_LSR_THRE = BIT(5),
+	UART_LSR_TEMT = BIT(6),
+};
+
+enum {
+	UART_USR_TFNF = BIT(1),
 };
 
 extern const struct driver uart_driver;
 extern const struct simple_device uart;
 
+/**
+ * Program the baud rate divisor from the current UART clock rate.
+ */
+void uart_set_divisor(const struct simple_device *self);
+
 #endif /* UART_PRIVATE_H */
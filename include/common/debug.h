@@ -6,6 +6,7 @@
 #ifndef COMMON_DEBUG_H
 #define COMMON_DEBUG_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <trap.h>
 
@@ -34,8 +35,54 @@ enum {
 };
 
 void hexdump(uintptr_t addr, uint32_t bytes);
+
+#if CONFIG(DEBUG_TOKENIZED_LOG)
+
+#define LOG_MAX_ARGS 7
+
+/*
+ * Place the format string in a section that is not loaded into SRAM, and use
+ * its offset within that section as its identifier. The string is recovered
+ * from the ELF file by tools/logdecode.
+ */
+#define LOG_TOKEN(fmt) __extension__ ({ \
+	static const char log_fmt[] ATTRIBUTE(section(".log_strings")) = fmt; \
+	(uintptr_t)log_fmt; })
+
+/* The first character of the format string (the level) is known at compile
+ * time, so it can be passed along without referencing the string itself. */
+#define LOG_HEADER(fmt, nargs) ((uint32_t)(nargs) << 8 | (uint8_t)(fmt)[0])
+
+#define LOG_NARGS(...) \
+	LOG_SELECT(__VA_ARGS__, 7, 6, 5, 4, 3, 2, 1, 0, ignored)
+#define LOG_SELECT(fmt, a1, a2, a3, a4, a5, a6, a7, x, ...) x
+
+#define LOG_ARGS(fmt, ...) \
+	log_token(LOG_HEADER(fmt, LOG_NARGS(fmt, __VA_ARGS__)), \
+	          LOG_TOKEN(fmt), __VA_ARGS__)
+#define LOG_NOARGS(fmt) \
+	log_token(LOG_HEADER(fmt, 0), LOG_TOKEN(fmt))
+
+#define log(...) \
+	LOG_SELECT(__VA_ARGS__, LOG_ARGS, LOG_ARGS, LOG_ARGS, LOG_ARGS, \
+	           LOG_ARGS, LOG_ARGS, LOG_ARGS, LOG_NOARGS, ignored)(__VA_ARGS__)
+
+/**
+ * Write a binary log record containing a format string identifier and the
+ * raw values of up to LOG_MAX_ARGS arguments. Use the log() macro instead of
+ * calling this function directly.
+ *
+ * @param header The number of arguments and the level of the message.
+ * @param token  The identifier of the format string.
+ */
+void log_token(uint32_t header, uintptr_t token, ...);
+
+#else
+
 void log(const char *fmt, ...) ATTRIBUTE(format(printf, 1, 2));
 
+#endif
+
 #define panic(...) (error(__VA_ARGS__), trap())
 #define error(...) log(LOG_STRING_ERROR __VA_ARGS__)
 #define warn(...)  log(LOG_STRING_WARNING __VA_ARGS__)
@@ -72,14 +119,113 @@ debug_print_battery(void)
 
 #endif
 
-#if CONFIG(DEBUG_PRINT_LATENCY)
+#define LATENCY_BUCKETS      16
+#define LATENCY_BUCKET_SHIFT 6
+
+/**
+ * The stable system states for which main loop latency is recorded.
+ */
+enum {
+	LATENCY_AWAKE,
+	LATENCY_ASLEEP,
+	LATENCY_OFF,
+	LATENCY_STATES
+};
+
+/**
+ * Main loop latency statistics for one system state, in AR100 cycles.
+ */
+struct latency_stats {
+	/** The number of main loop iterations recorded. */
+	uint32_t iterations;
+	/** The shortest iteration. */
+	uint32_t min;
+	/** The longest iteration. */
+	uint32_t max;
+	/** The sum of recent iterations, used to compute the mean. */
+	uint32_t sum;
+	/** The number of iterations included in the sum. */
+	uint32_t samples;
+	/** Bucket n counts iterations shorter than 2^(n+LATENCY_BUCKET_SHIFT)
+	 *  cycles. The last bucket counts all remaining iterations. */
+	uint32_t histogram[LATENCY_BUCKETS];
+};
 
-void debug_print_latency(uint8_t current_state);
+#if CONFIG(DEBUG_LATENCY_STATS)
+
+/**
+ * Discard the main loop iteration in progress.
+ *
+ * Call this when entering a new state, so the time spent in the transition is
+ * not recorded as an iteration of either state.
+ */
+void debug_discard_latency(void);
+
+/**
+ * Get the latency statistics for a system state.
+ *
+ * @param state One of the LATENCY_* states.
+ * @return      A pointer to the statistics, or NULL if the state is invalid.
+ */
+const struct latency_stats *debug_get_latency_stats(uint8_t state);
+
+/**
+ * Calculate the mean iteration latency from a set of statistics.
+ */
+uint32_t debug_latency_mean(const struct latency_stats *s);
+
+/**
+ * Print the latency statistics for all system states.
+ */
+void debug_print_latency_stats(void);
+
+/**
+ * Record the latency of the main loop iteration ending now.
+ *
+ * Call this once per main loop iteration while in a stable state. Iterations
+ * where the state changes, or that include a call to debug_discard_latency(),
+ * are not recorded.
+ *
+ * @param state One of the LATENCY_* states.
+ */
+void debug_record_latency(uint8_t state);
+
+/**
+ * Clear the latency statistics for all system states.
+ */
+void debug_reset_latency_stats(void);
 
 #else
 
 static inline void
-debug_print_latency(uint8_t current_state UNUSED)
+debug_discard_latency(void)
+{
+}
+
+static inline const struct latency_stats *
+debug_get_latency_stats(uint8_t state UNUSED)
+{
+	return NULL;
+}
+
+static inline uint32_t
+debug_latency_mean(const struct latency_stats *s UNUSED)
+{
+	return 0;
+}
+
+static inline void
+debug_print_latency_stats(void)
+{
+}
+
+static inline void
+debug_record_latency(uint8_t state UNUSED)
+{
+}
+
+static inline void
+debug_reset_latency_stats(void)
 {
 }
 
@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_ENERGY_H
+#define COMMON_ENERGY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ENERGY_STATS_MAGIC 0x43524e45 /* "CRNE" */
+
+/**
+ * The stable system states for which energy usage is recorded.
+ */
+enum {
+	ENERGY_AWAKE,
+	ENERGY_ASLEEP,
+	ENERGY_OFF,
+	ENERGY_STATES
+};
+
+/**
+ * Energy accounting for one system state.
+ */
+struct energy_state_stats {
+	/** Battery energy used while it was measured, in microjoules. */
+	uint64_t energy_uJ;
+	/** Time spent in this state while the battery was discharging and
+	 *  its power usage could be measured, in milliseconds. */
+	uint32_t measured_ms;
+	/** Total time spent in this state, in milliseconds. */
+	uint32_t time_ms;
+	/** The number of times this state was entered. */
+	uint32_t entries;
+	/** The number of battery measurements taken in this state. */
+	uint32_t samples;
+};
+
+/**
+ * The layout of the energy accounting data, located at ENERGY_BASE in SRAM A2.
+ *
+ * The contents are kept across firmware restarts.
+ */
+struct energy_stats {
+	/** ENERGY_STATS_MAGIC once the structure is initialized. */
+	uint32_t                  magic;
+	/** The number of times the system woke up from suspend. */
+	uint32_t                  wakeups;
+	/** The most recently measured battery voltage, in millivolts. */
+	uint32_t                  last_mV;
+	/** The most recently measured discharge current, in milliamps. */
+	uint32_t                  last_mA;
+	/** The most recently read fuel gauge level, in percent. */
+	uint32_t                  last_percent;
+	/** Reserved for future use; always zero. */
+	uint32_t                  reserved;
+	/** Accounting for each of the ENERGY_* states. */
+	struct energy_state_stats states[ENERGY_STATES];
+};
+
+#if CONFIG(ENERGY_STATS)
+
+/**
+ * Calculate the average battery power used in a system state, in milliwatts.
+ */
+uint32_t energy_average_mW(const struct energy_state_stats *s);
+
+/**
+ * Get the energy accounting data.
+ */
+const struct energy_stats *energy_get_stats(void);
+
+/**
+ * Initialize the energy accounting data, unless it already contains valid
+ * data from before a firmware restart.
+ */
+void energy_init(void);
+
+/**
+ * Clear the energy accounting data.
+ */
+void energy_reset(void);
+
+/**
+ * Account for time spent in the current system state, and measure battery
+ * power usage if the measurement interval has passed.
+ *
+ * This function must be called from each iteration of the main loop.
+ *
+ * @param state One of the ENERGY_* states.
+ */
+void energy_update(uint8_t state);
+
+#else
+
+static inline uint32_t
+energy_average_mW(const struct energy_state_stats *s UNUSED)
+{
+	return 0;
+}
+
+static inline const struct energy_stats *
+energy_get_stats(void)
+{
+	return NULL;
+}
+
+static inline void
+energy_init(void)
+{
+}
+
+static inline void
+energy_reset(void)
+{
+}
+
+static inline void
+energy_update(uint8_t state UNUSED)
+{
+}
+
+#endif
+
+#endif /* COMMON_ENERGY_H */
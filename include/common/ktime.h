@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_KTIME_H
+#define COMMON_KTIME_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Add a number of milliseconds to a monotonic time.
+ *
+ * @param time     A monotonic time, in microseconds.
+ * @param mseconds The number of milliseconds to add.
+ * @return         The resulting monotonic time.
+ */
+uint64_t ktime_add_ms(uint64_t time, uint32_t mseconds);
+
+/**
+ * Add a number of seconds to a monotonic time.
+ *
+ * @param time    A monotonic time, in microseconds.
+ * @param seconds The number of seconds to add.
+ * @return        The resulting monotonic time.
+ */
+uint64_t ktime_add_sec(uint64_t time, uint32_t seconds);
+
+/**
+ * Check if a monotonic deadline has passed.
+ *
+ * @param deadline A monotonic time, in microseconds.
+ * @return         Whether or not the current time is at or after the deadline.
+ */
+bool ktime_expired(uint64_t deadline);
+
+/**
+ * Get the current monotonic time.
+ *
+ * Monotonic time is accumulated from the system counter while OSC24M runs.
+ * Otherwise, it is accumulated from the cycle counter, scaled by the CPU
+ * clock frequency at the time, since the cycle counter keeps running in every
+ * suspend state. Unlike the timeouts provided by timeout.h, deadlines may be
+ * arbitrarily far in the future, and they are not affected by changes to the
+ * CPU clock. While OSC24M is stopped, accuracy depends on the calibration of
+ * the CPU clock source.
+ *
+ * @return The current monotonic time, in microseconds.
+ */
+uint64_t ktime_get(void);
+
+/**
+ * Update the monotonic time from the counter in use.
+ *
+ * This must be called at least once per 2^32 counter ticks, and immediately
+ * before changing the CPU clock frequency. That is 179 seconds of the 24 MHz
+ * system counter, or 2^32 CPU cycles while OSC24M is stopped, when the CPU
+ * runs from the internal oscillator (over 268 seconds at 16 MHz).
+ */
+void ktime_poll(void);
+
+/**
+ * Select the counter used to update the monotonic time.
+ *
+ * This must be called with false before OSC24M is stopped, and with true
+ * once it runs again. Until the first call, the cycle counter is used.
+ *
+ * @param enable Whether to use the system counter instead of the cycle
+ *               counter.
+ */
+void ktime_use_system_counter(bool enable);
+
+#endif /* COMMON_KTIME_H */
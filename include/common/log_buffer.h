@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_LOG_BUFFER_H
+#define COMMON_LOG_BUFFER_H
+
+#include <stdint.h>
+
+#define LOG_BUFFER_MAGIC 0x43524c47 /* "CRLG" */
+
+/**
+ * The layout of the log buffer, located at LOG_BUF_BASE in SRAM A2.
+ *
+ * The buffer is shared with readers running on the ARM CPUs. Bytes in the
+ * data array are stored in ARM byte order, so they can be read sequentially.
+ */
+struct log_buffer {
+	/** LOG_BUFFER_MAGIC once the header is initialized. */
+	uint32_t magic;
+	/** The size of the data array in bytes. */
+	uint32_t size;
+	/** The offset in the data array where the next byte will be written. */
+	uint32_t index;
+	/** The total number of bytes ever written, modulo 2^32. */
+	uint32_t count;
+	/** The circular array of log output. */
+	uint8_t  data[];
+};
+
+#if CONFIG(DEBUG_LOG_BUFFER)
+
+/**
+ * Initialize the log buffer, unless it already contains valid data.
+ *
+ * Existing contents are preserved across firmware restarts, so the log output
+ * leading up to an exception is available afterward.
+ */
+void log_buffer_init(void);
+
+/**
+ * Append a character to the log buffer, overwriting the oldest data.
+ */
+void log_buffer_putc(char c);
+
+/**
+ * Append raw bytes to the log buffer, overwriting the oldest data.
+ */
+void log_buffer_write(const uint8_t *data, uint32_t size);
+
+#else
+
+static inline void
+log_buffer_init(void)
+{
+}
+
+static inline void
+log_buffer_putc(char c UNUSED)
+{
+}
+
+static inline void
+log_buffer_write(const uint8_t *data UNUSED, uint32_t size UNUSED)
+{
+}
+
+#endif
+
+#endif /* COMMON_LOG_BUFFER_H */
@@ -23,7 +23,9 @@ bool timeout_expired(uint32_t timeout);
 /**
  * Set a timeout for some point in the near future.
  *
- * Timeouts must not be set for greater than approximately one minute.
+ * Timeouts are based on the CPU cycle counter, so they are only suitable for
+ * short busy-wait loops while the CPU clock is constant. They must not be set
+ * for greater than approximately one minute. Use ktime.h for longer delays.
  *
  * @param useconds The delay in microseconds before the timeout expires.
  * @return         An opaque number that can be passed to timeout_expired().
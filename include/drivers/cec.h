@@ -7,6 +7,7 @@
 #define DRIVERS_CEC_H
 
 #include <device.h>
+#include <error.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -29,6 +30,18 @@ const struct device *cec_get(void);
  */
 uint32_t cec_poll(const struct device *dev);
 
+/**
+ * Select the CEC messages that can wake the system.
+ *
+ * The filter takes effect the next time the CEC receiver is acquired.
+ *
+ * @param messages   A bitmask of wakeup messages, in the same format as
+ *                   CONFIG_CEC_WAKE_MESSAGES.
+ * @param initiators A bitmask of logical addresses allowed to send them.
+ * @return           Zero on success; an error code on failure.
+ */
+int cec_set_wake_filter(uint32_t messages, uint32_t initiators);
+
 #else
 
 static inline const struct device *
@@ -43,6 +56,12 @@ cec_poll(const struct device *dev UNUSED)
 	return 0;
 }
 
+static inline int
+cec_set_wake_filter(uint32_t messages UNUSED, uint32_t initiators UNUSED)
+{
+	return ENOTSUP;
+}
+
 #endif
 
 #endif /* DRIVERS_CEC_H */
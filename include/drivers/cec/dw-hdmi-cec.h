@@ -19,5 +19,6 @@ struct dw_hdmi_cec {
 extern const struct dw_hdmi_cec hdmi_cec;
 
 uint32_t dw_hdmi_cec_poll(const struct device *dev);
+int dw_hdmi_cec_set_wake_filter(uint32_t messages, uint32_t initiators);
 
 #endif /* DRIVERS_CEC_DW_HDMI_CEC_H */
@@ -7,9 +7,25 @@
 #define DRIVERS_CIR_H
 
 #include <device.h>
+#include <error.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/** The maximum number of wakeup scan codes. */
+#define CIR_MAX_WAKE_CODES 8
+
+/**
+ * IR protocols, as used to identify wakeup scan codes.
+ */
+enum {
+	CIR_PROTOCOL_NEC  = 0,
+	CIR_PROTOCOL_NECX = 1,
+	CIR_PROTOCOL_RC5  = 2,
+	CIR_PROTOCOL_RC6  = 3,
+	CIR_PROTOCOL_SIRC = 4,
+	CIR_PROTOCOLS
+};
+
 #if CONFIG(CIR)
 
 /**
@@ -29,6 +45,19 @@ const struct device *cir_get(void);
  */
 uint32_t cir_poll(const struct device *dev);
 
+/**
+ * Set or clear an entry in the table of wakeup scan codes.
+ *
+ * The table takes effect the next time the CIR receiver is acquired. While
+ * the table is empty, the scan code selected in Kconfig is used.
+ *
+ * @param index    The index of the table entry.
+ * @param protocol The protocol of the scan code.
+ * @param code     The scan code, or zero to clear the entry.
+ * @return         Zero on success; an error code on failure.
+ */
+int cir_set_wake_code(uint8_t index, uint8_t protocol, uint32_t code);
+
 #else
 
 static inline const struct device *
@@ -43,6 +72,13 @@ cir_poll(const struct device *dev UNUSED)
 	return 0;
 }
 
+static inline int
+cir_set_wake_code(uint8_t index UNUSED, uint8_t protocol UNUSED,
+                  uint32_t code UNUSED)
+{
+	return ENOTSUP;
+}
+
 #endif
 
 #endif /* DRIVERS_CIR_H */
@@ -9,8 +9,11 @@
 #include <clock.h>
 #include <device.h>
 #include <gpio.h>
+#include <stdbool.h>
 #include <stdint.h>
 
+#define SUNXI_CIR_FIFO_SIZE 64
+
 struct sunxi_cir {
 	struct device       dev;
 	struct clock_handle bus_clock;
@@ -21,6 +24,18 @@ struct sunxi_cir {
 
 extern const struct sunxi_cir r_cir_rx;
 
-uint32_t sunxi_cir_poll(const struct device *dev);
+/**
+ * Drain the receiver FIFO once it reaches its threshold or a packet ends.
+ *
+ * Bit 7 of each sample is the pulse type (mark or space); the remaining bits
+ * are the pulse width in clock cycles.
+ *
+ * @param dev     A reference to the CIR receiver device.
+ * @param samples A buffer for at least SUNXI_CIR_FIFO_SIZE samples.
+ * @param idle    Set if the receiver has gone idle after the last sample.
+ * @return        The number of samples stored in the buffer.
+ */
+uint8_t sunxi_cir_poll(const struct device *dev, uint8_t *samples,
+                       bool *idle);
 
 #endif /* DRIVERS_CIR_SUNXI_CIR_H */
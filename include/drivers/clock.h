@@ -31,6 +31,17 @@ struct clock_handle {
  */
 bool clock_active(const struct clock_handle *clock);
 
+/**
+ * Enable or disable caching of computed clock rates.
+ *
+ * Caching is only safe while the rich OS is stopped, because it may
+ * reprogram the clocks it owns at any time. Changing the setting also
+ * drops any rates already cached.
+ *
+ * @param enable Whether to cache computed rates.
+ */
+void clock_cache_rates(bool enable);
+
 /**
  * Disable a clock.
  *
@@ -8,6 +8,7 @@
 
 #include <clock.h>
 #include <device.h>
+#include <stdbool.h>
 #if CONFIG(PLATFORM_A23)
 #include <clock/sun8i-a23-ccu.h>
 #include <clock/sun8i-r-ccu.h>
@@ -29,17 +30,95 @@ struct ccu {
 	struct device           dev;
 	const struct ccu_clock *clocks;
 	uintptr_t               regs;
+	uint8_t                 nclocks;
 };
 
 extern const struct ccu ccu;
 extern const struct ccu r_ccu;
 
+/**
+ * Start collecting CCU gate and reset changes instead of applying them.
+ *
+ * Changes to the same register are merged. When the batch is applied, PLLs
+ * are enabled first, so several PLLs can lock in parallel. Other changes are
+ * applied only after every PLL has locked. Batches may be nested.
+ */
+void ccu_batch_begin(void);
+
+/**
+ * Apply all pending CCU changes, and close the innermost batch.
+ */
+void ccu_batch_commit(void);
+
+/**
+ * Apply all pending CCU changes, leaving any batch open.
+ */
+void ccu_batch_flush(void);
+
+#if CONFIG(CCU_GATE_AUDIT)
+
+/**
+ * Find bus clocks in the CCU that are running without any references.
+ *
+ * This checks every gate in the SoC's bus clock gate registers, including
+ * gates for devices unknown to the firmware. PLLs are never checked. Each
+ * open gate is logged. If CONFIG_CCU_GATE_AUDIT_FORCE is enabled, the gates
+ * not listed as needed while asleep are also closed, until the next call to
+ * ccu_gate_audit_restore().
+ *
+ * @return The number of clocks found running.
+ */
+uint32_t ccu_gate_audit(void);
+
+/**
+ * Ungate the clocks gated by ccu_gate_audit().
+ */
+void ccu_gate_audit_restore(void);
+
+#else
+
+static inline uint32_t
+ccu_gate_audit(void)
+{
+	return 0;
+}
+
+static inline void
+ccu_gate_audit_restore(void)
+{
+}
+
+#endif
+
 void ccu_suspend(void);
 void ccu_suspend_cluster(uint32_t cluster);
 void ccu_resume(void);
 void ccu_resume_cluster(uint32_t cluster);
 void ccu_init(void);
 
+/**
+ * Select the AR100 clock for the current system state.
+ *
+ * When boosted, the AR100 runs from PLL_PERIPH0, if it is enabled. Otherwise,
+ * the AR100 runs from the internal oscillator, divided down according to
+ * CONFIG_CPUS_CLK_SLEEP_SHIFT. Any UART attached to the R_CCU must be flushed
+ * before and reprogrammed after calling this function.
+ *
+ * @param boost Whether the system is awake.
+ */
+void r_ccu_set_cpus_clock(bool boost);
+
+/**
+ * Perform background R_CCU work, such as refining the IOSC calibration.
+ *
+ * While the AR100 runs from IOSC, this also tracks IOSC drift against the
+ * system counter. When the IOSC rate changes, the AR100 clock should be
+ * selected again, so the cycle counter and UART pick up the new rate.
+ *
+ * @return True if the IOSC rate was updated, else false.
+ */
+bool r_ccu_poll(void);
+
 void r_ccu_suspend(uint8_t depth);
 void r_ccu_resume(void);
 void r_ccu_init(void);
@@ -23,6 +23,22 @@ void cycle_counter_init(void);
  */
 uint32_t cycle_counter_read(void);
 
+/**
+ * Get the number of cycle counter ticks per millisecond.
+ *
+ * This follows the CPU clock frequency, so it changes whenever the CPU clock
+ * is reconfigured. Whole megahertz are too coarse for the divided IOSC rates
+ * used while asleep.
+ */
+uint32_t cycle_counter_rate_khz(void);
+
+/**
+ * Update the cycle counter frequency after a change to the CPU clock.
+ *
+ * @param rate The new CPU clock frequency in Hz.
+ */
+void cycle_counter_set_rate(uint32_t rate);
+
 /**
  * Read the system counter.
  *
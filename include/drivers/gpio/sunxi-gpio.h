@@ -6,8 +6,12 @@
 #ifndef DRIVERS_GPIO_SUNXI_GPIO_H
 #define DRIVERS_GPIO_SUNXI_GPIO_H
 
+#include <device.h>
+#include <error.h>
 #include <gpio.h>
 #include <simple_device.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define SUNXI_GPIO_PIN(port, pin) (32 * (port) + (pin))
 
@@ -21,6 +25,7 @@ enum {
 enum {
 	MODE_INPUT   = 0,
 	MODE_OUTPUT  = 1,
+	MODE_EINT    = 6,
 	MODE_DISABLE = 7,
 };
 
@@ -30,7 +35,80 @@ enum {
 	PULL_DOWN = 2,
 };
 
+enum {
+	TRIGGER_RISING  = 0,
+	TRIGGER_FALLING = 1,
+	TRIGGER_HIGH    = 2,
+	TRIGGER_LOW     = 3,
+	TRIGGER_BOTH    = 4,
+};
+
 extern const struct simple_device pio;
 extern const struct simple_device r_pio;
 
+/* Pin mask that restores the Kconfig default wakeup configuration. */
+#define SUNXI_GPIO_WAKE_DEFAULT UINT32_MAX
+
+#if CONFIG(R_PIO_WAKE)
+
+/**
+ * Select the port L pins used as wakeup sources, overriding the Kconfig
+ * default. The change takes effect at the next suspend.
+ *
+ * @param pins    A bitmask of port L pins, where zero disables GPIO wakeup,
+ *                or SUNXI_GPIO_WAKE_DEFAULT to use the default again.
+ * @param trigger The trigger condition, one of the TRIGGER_* values.
+ * @return        Zero on success; an error code on failure.
+ */
+int sunxi_gpio_set_wake(uint32_t pins, uint8_t trigger);
+
+/**
+ * Configure the port L wakeup pins and start watching them for events.
+ *
+ * @return A reference to the R_PIO device, or NULL if no pins are selected.
+ */
+const struct device *sunxi_gpio_wake_get(void);
+
+/**
+ * Check the port L wakeup pins for events.
+ *
+ * @param dev The reference returned by sunxi_gpio_wake_get().
+ * @return    A bitmask of the pins with pending events.
+ */
+uint32_t sunxi_gpio_wake_poll(const struct device *dev);
+
+/**
+ * Restore the previous port L pin configuration and release the reference.
+ *
+ * @param dev The reference returned by sunxi_gpio_wake_get(), or NULL.
+ */
+void sunxi_gpio_wake_put(const struct device *dev);
+
+#else
+
+static inline int
+sunxi_gpio_set_wake(uint32_t pins UNUSED, uint8_t trigger UNUSED)
+{
+	return ENOTSUP;
+}
+
+static inline const struct device *
+sunxi_gpio_wake_get(void)
+{
+	return NULL;
+}
+
+static inline uint32_t
+sunxi_gpio_wake_poll(const struct device *dev UNUSED)
+{
+	return 0;
+}
+
+static inline void
+sunxi_gpio_wake_put(const struct device *dev UNUSED)
+{
+}
+
+#endif
+
 #endif /* DRIVERS_GPIO_SUNXI_GPIO_H */
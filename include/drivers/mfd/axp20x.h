@@ -7,7 +7,45 @@
 #define DRIVERS_MFD_AXP20X_H
 
 #include <regmap.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 extern const struct regmap_device axp20x;
 
+#if CONFIG(MFD_AXP20X_IRQ)
+
+/**
+ * Decode a pending PMIC interrupt and apply the wakeup policy.
+ *
+ * Events from sources that should not wake the system are acknowledged in
+ * the PMIC. Events from wakeup sources are left pending for the rich OS.
+ *
+ * @return Nonzero if the interrupt should wake the system, else zero.
+ */
+uint32_t axp20x_irq_poll(void);
+
+/**
+ * Check if PMIC interrupts are being held off after discarding an event.
+ *
+ * While this returns true, the PMIC interrupt must be left pending, so any
+ * event arriving during the holdoff is decoded once it ends.
+ */
+bool axp20x_irq_held_off(void);
+
+#else
+
+static inline uint32_t
+axp20x_irq_poll(void)
+{
+	return 1;
+}
+
+static inline bool
+axp20x_irq_held_off(void)
+{
+	return false;
+}
+
+#endif
+
 #endif /* DRIVERS_MFD_AXP20X_H */
@@ -10,9 +10,17 @@
 #include <intrusive.h>
 #include <stdint.h>
 
+struct regmap_cache {
+	const uint8_t *regs;  /**< Sorted list of cacheable registers. */
+	uint8_t       *vals;  /**< Cached values, one per cacheable register. */
+	uint32_t      *valid; /**< Bitmap of cached values that are valid. */
+	uint8_t        count; /**< The number of cacheable registers (<= 32). */
+};
+
 struct regmap {
-	const struct device *dev;
-	uint32_t             id;
+	const struct device       *dev;
+	uint32_t                   id;
+	const struct regmap_cache *cache; /**< Optional register cache. */
 };
 
 struct regmap_device {
@@ -50,6 +58,41 @@ int regmap_get(const struct regmap *map);
  */
 void regmap_put(const struct regmap *map);
 
+/**
+ * Raise the bus clock rate as far as the device reliably supports.
+ *
+ * The rate is validated by repeatedly reading a register with a known,
+ * constant value. The chosen rate is kept by the bus controller until the
+ * firmware restarts, so this only has an effect the first time it is called.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *   ENOTSUP The bus does not support changing its rate.
+ *
+ * @param map  A reference to the regmap.
+ * @param reg  A register that always reads back the same value.
+ * @return     Zero on success; an error code on failure.
+ */
+int regmap_tune_rate(const struct regmap *map, uint8_t reg);
+
+/**
+ * Invalidate all cached register values in a regmap.
+ *
+ * This must be called whenever the device may have changed the value of a
+ * cached register on its own, such as after resuming from suspend. It has no
+ * effect if the regmap has no cache.
+ *
+ * @param map  A reference to a regmap.
+ */
+#if CONFIG(REGMAP_CACHE)
+void regmap_invalidate_cache(const struct regmap *map);
+#else
+static inline void
+regmap_invalidate_cache(const struct regmap *map UNUSED)
+{
+}
+#endif
+
 /**
  * Read a value from a regmap.
  *
@@ -76,6 +119,45 @@ int regmap_read(const struct regmap *map, uint8_t reg, uint8_t *val);
  */
 int regmap_write(const struct regmap *map, uint8_t reg, uint8_t val);
 
+/**
+ * Read a range of consecutive registers from a regmap.
+ *
+ * If the bus supports it, this uses fewer transactions than reading each
+ * register individually.
+ * The device must advance to the next register after each byte of a burst.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *
+ * @param map   A reference to the regmap.
+ * @param reg   The first register to read.
+ * @param vals  The location to save the values read from the registers.
+ * @param count The number of registers to read.
+ * @return      Zero on success; an error code on failure.
+ */
+int regmap_read_bulk(const struct regmap *map, uint8_t reg, uint8_t *vals,
+                     uint8_t count);
+
+/**
+ * Write a range of consecutive registers in a regmap.
+ *
+ * If the bus supports it, this uses fewer transactions than writing each
+ * register individually. Over RSB, the device must advance to the next
+ * register after each byte of a burst. Over I²C, each value is sent along
+ * with its register address, as X-Powers PMICs expect.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *
+ * @param map   A reference to the regmap.
+ * @param reg   The first register to write.
+ * @param vals  The values to write to the registers.
+ * @param count The number of registers to write.
+ * @return      Zero on success; an error code on failure.
+ */
+int regmap_write_bulk(const struct regmap *map, uint8_t reg,
+                      const uint8_t *vals, uint8_t count);
+
 /**
  * Update a bitfield in a regmap register.
  *
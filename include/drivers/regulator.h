@@ -28,6 +28,27 @@ struct regulator_handle {
  */
 int regulator_disable(const struct regulator_handle *handle);
 
+/**
+ * Disable the outputs of a list of regulators. Regulators sharing a supplier
+ * device are switched together, at the position of the first of them in the
+ * list. This allows the supplier to batch its register accesses.
+ *
+ * Since the order within a supplier is not kept, this must not be used where
+ * one regulator must be switched before another.
+ *
+ * This function will acquire and release a reference to each supplier device.
+ * It attempts to disable every regulator, even if some of them fail.
+ *
+ * This function may fail with:
+ *   EIO    There was a problem communicating with the hardware.
+ *
+ * @param handles A list of references to regulators and their suppliers.
+ * @param count   The number of regulators in the list (at most 32).
+ * @return        Zero on success; the first error code on failure.
+ */
+int regulator_bulk_disable(const struct regulator_handle *const *handles,
+                           uint8_t count);
+
 /**
  * Enable the output of a regulator. If the regulator does not have
  * output on/off control, this function may have no effect on the hardware.
@@ -42,6 +63,44 @@ int regulator_disable(const struct regulator_handle *handle);
  */
 int regulator_enable(const struct regulator_handle *handle);
 
+/**
+ * Put a regulator that stays on during suspend into its low-power state.
+ *
+ * The regulator's output voltage is lowered to the given voltage, and it is
+ * switched to a more efficient mode for light loads, if supported. The
+ * previous settings are saved, to be restored by regulator_exit_retention().
+ * The voltage is never raised by this function.
+ *
+ * This function will acquire and release a reference to the supplier device.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *   ENOTSUP The regulator does not have a low-power state.
+ *
+ * @param handle A reference to a regulator and its supplier.
+ * @param mV     The minimum voltage needed while suspended, in millivolts,
+ *               or zero to keep the current voltage.
+ * @return       Zero on success; a defined error code on failure.
+ */
+int regulator_enter_retention(const struct regulator_handle *handle,
+                              uint16_t mV);
+
+/**
+ * Restore the settings saved by regulator_enter_retention().
+ *
+ * This function has no effect if the regulator is not in its low-power state.
+ *
+ * This function will acquire and release a reference to the supplier device.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *   ENOTSUP The regulator does not have a low-power state.
+ *
+ * @param handle A reference to a regulator and its supplier.
+ * @return       Zero on success; a defined error code on failure.
+ */
+int regulator_exit_retention(const struct regulator_handle *handle);
+
 /**
  * Get the current state of a regulator, as determined from the hardware.
  *
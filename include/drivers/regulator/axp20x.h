@@ -9,11 +9,14 @@
 #include <device.h>
 #include <regmap.h>
 #include <regulator.h>
+#include <stdint.h>
 
 struct axp20x_regulator {
 	struct device                       dev;
 	const struct regmap                *map;
 	const struct axp20x_regulator_info *info;
+	const struct axp20x_retention_info *retention;
+	uint8_t                             retention_count;
 };
 
 #endif /* DRIVERS_REGULATOR_AXP20X_H */
@@ -7,6 +7,7 @@
 #define DRIVERS_SERIAL_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #if CONFIG(SERIAL)
 
@@ -19,11 +20,57 @@ char serial_getc(void);
 void serial_putc(char c);
 void serial_puts(const char *s);
 
+/**
+ * Write raw bytes to the UART, without any newline translation.
+ *
+ * If output is buffered and the data does not fit in the buffer, it may be
+ * dropped, but it will never be partially written.
+ *
+ * @param data A pointer to the data.
+ * @param size The number of bytes to write.
+ */
+void serial_write(const uint8_t *data, uint32_t size);
+
+/**
+ * Write out all buffered output, and wait for the UART to finish sending it.
+ *
+ * This function must be called before anything that could lose buffered
+ * output, such as a trap or a change to the UART's clock.
+ */
+void serial_flush(void);
+
 /**
  * Initialize the UART.
  */
 void serial_init(void);
 
+#if CONFIG(SERIAL_TX_BUFFER)
+
+/**
+ * Write out output buffered before an exception, before .bss is cleared.
+ *
+ * This function is called from the exception entry path. If the flush itself
+ * causes another exception, the output is discarded on the second entry.
+ */
+void serial_rescue(void);
+
+#endif
+
+/**
+ * Copy buffered output to the UART, as long as there is space in its FIFO.
+ *
+ * This function never waits for the UART. It should be called regularly from
+ * the main loop.
+ */
+void serial_poll(void);
+
+/**
+ * Reprogram the UART after a change to its clock rate.
+ *
+ * Output must be flushed before the clock rate is changed.
+ */
+void serial_update_rate(void);
+
 /**
  * Verify that the UART is ready to use.
  *
@@ -50,11 +97,31 @@ serial_puts(const char *s UNUSED)
 {
 }
 
+static inline void
+serial_write(const uint8_t *data UNUSED, uint32_t size UNUSED)
+{
+}
+
+static inline void
+serial_flush(void)
+{
+}
+
 static inline void
 serial_init(void)
 {
 }
 
+static inline void
+serial_poll(void)
+{
+}
+
+static inline void
+serial_update_rate(void)
+{
+}
+
 static inline bool
 serial_ready(void)
 {
@@ -11,6 +11,25 @@
 #define UDIV_ROUND(dividend, divisor) \
 	(((dividend) + (divisor) / 2) / (divisor))
 
+/**
+ * Compute a full 64-bit product from 16-bit partial products, since there is
+ * no runtime support for 64-bit multiplication.
+ */
+static inline uint64_t
+mul_u32_u32(uint32_t a, uint32_t b)
+{
+	uint32_t ah = a >> 16, al = a & 0xffff;
+	uint32_t bh = b >> 16, bl = b & 0xffff;
+	uint64_t product;
+
+	product  = (uint64_t)(ah * bh) << 32;
+	product += (uint64_t)(ah * bl) << 16;
+	product += (uint64_t)(al * bh) << 16;
+	product += al * bl;
+
+	return product;
+}
+
 /**
  * Perform correctly-rounded unsigned division.
  */
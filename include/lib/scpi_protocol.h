@@ -91,6 +91,23 @@ enum {
 	SCPI_E_STATE    = 15, /**< Invalid or unattainable state requested. */
 };
 
+/**
+ * The set of vendor-specific SCPI commands, implemented only by this firmware.
+ *
+ * These commands use the extended command set (set ID 1). Since the set ID bit
+ * is merged into the command number, they are numbered starting at 0x80.
+ */
+enum {
+	SCPI_CMD_VENDOR_BASE         = 0x80,
+	SCPI_CMD_GET_LATENCY_STATS   = 0x80, /**< Get main loop latency stats. */
+	SCPI_CMD_RESET_LATENCY_STATS = 0x81, /**< Reset main loop latency stats. */
+	SCPI_CMD_GET_ENERGY_STATS    = 0x82, /**< Get battery energy stats. */
+	SCPI_CMD_RESET_ENERGY_STATS  = 0x83, /**< Reset battery energy stats. */
+	SCPI_CMD_SET_GPIO_WAKE       = 0x84, /**< Set port L wakeup pins. */
+	SCPI_CMD_SET_CIR_WAKE_CODE   = 0x85, /**< Set a CIR wakeup scan code. */
+	SCPI_CMD_SET_CEC_WAKE        = 0x86, /**< Set CEC wakeup messages. */
+};
+
 /**
  * Possible CSS power domain states, as used in existing SCPI implementations.
  */
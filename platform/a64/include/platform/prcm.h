@@ -12,6 +12,7 @@
 #define CPUS_CLK_REG                      (DEV_R_PRCM + 0x0000)
 #define CPUS_CLK_REG_CLK_SRC(x)           ((x) << 16)
 #define CPUS_CLK_REG_CLK_SRC_MASK         (0x3 << 16)
+#define CPUS_CLK_REG_CLK_SRC_IOSC         CPUS_CLK_REG_CLK_SRC(3)
 #define CPUS_CLK_REG_PRE_DIV(x)           ((x) << 8)
 #define CPUS_CLK_REG_PRE_DIV_MASK         (0x1f << 8)
 #define CPUS_CLK_REG_DIV_P(x)             ((x) << 4)
@@ -7,9 +7,18 @@
 #define PLATFORM_MEMORY_H
 
 #define FIRMWARE_BASE  0x00008000
-#define FIRMWARE_LIMIT SCPI_MEM_BASE
+#define FIRMWARE_LIMIT LOG_BUF_BASE
 #define FIRMWARE_SIZE  (FIRMWARE_LIMIT - FIRMWARE_BASE)
 
+#define LOG_BUF_BASE   (LOG_BUF_LIMIT - LOG_BUF_SIZE)
+#define LOG_BUF_LIMIT  ENERGY_BASE
+#define LOG_BUF_SIZE   (0 IF_ENABLED(CONFIG_DEBUG_LOG_BUFFER, \
+	                             + CONFIG_DEBUG_LOG_BUFFER_SIZE))
+
+#define ENERGY_BASE    (ENERGY_LIMIT - ENERGY_SIZE)
+#define ENERGY_LIMIT   SCPI_MEM_BASE
+#define ENERGY_SIZE    (0 IF_ENABLED(CONFIG_ENERGY_STATS, + 0x80))
+
 #define SCPI_MEM_BASE  (SRAM_A2_LIMIT - 0x400)
 #define SCPI_MEM_LIMIT SRAM_A2_LIMIT
 #define SCPI_MEM_SIZE  (SCPI_MEM_LIMIT - SCPI_MEM_BASE)
@@ -0,0 +1,590 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <compiler.h>
+#include <config.h>
+#include <kconfig.h>
+#include <util.h>
+#include <platform/time.h>
+
+/*
+ * Build every decoder, regardless of which ones the firmware uses. The
+ * sample rate follows the firmware configuration, so rebuild with
+ * CIR_USE_OSC24M toggled to measure the other rate.
+ */
+#undef CONFIG_CIR_DECODER_NEC
+#undef CONFIG_DEBUG_TOKENIZED_LOG
+#undef CONFIG_CIR_DECODER_NECX
+#define CONFIG_CIR_DECODER_NEC  1
+#define CONFIG_CIR_DECODER_NECX 1
+#ifndef CONFIG_CIR_CLK_RATE
+#define CONFIG_CIR_CLK_RATE     32768
+#endif
+#ifndef CONFIG_CPUS_CLK_SLEEP_SHIFT
+#define CONFIG_CPUS_CLK_SLEEP_SHIFT 0
+#endif
+
+#include "../drivers/cir/nec.c"
+#include "../drivers/cir/rc5.c"
+#include "../drivers/cir/rc6.c"
+#include "../drivers/cir/sirc.c"
+
+#define MAX_PULSES       512
+#define MAX_SAMPLES      (1 << 22)
+#define MAX_TRIALS       (1 << 16)
+#define SAMPLE_MAX_WIDTH 127
+
+/* Idle time between frames, as seen between key repeats. */
+#define IDLE_US          40000
+
+enum {
+	DEC_NEC,
+	DEC_NECX,
+	DEC_RC5,
+	DEC_RC6,
+	DEC_SIRC,
+	DECODERS
+};
+
+struct decoder {
+	const char *name;
+	uint32_t  (*decode)(struct cir_dec_ctx *ctx);
+};
+
+static const struct decoder decoders[DECODERS] = {
+	[DEC_NEC]  = { "nec",  cir_decode_nec  },
+	[DEC_NECX] = { "necx", cir_decode_necx },
+	[DEC_RC5]  = { "rc5",  cir_decode_rc5  },
+	[DEC_RC6]  = { "rc6",  cir_decode_rc6  },
+	[DEC_SIRC] = { "sirc", cir_decode_sirc },
+};
+
+struct pulse {
+	bool     mark;
+	uint32_t us;
+};
+
+struct waveform {
+	const char  *name;
+	struct pulse pulses[MAX_PULSES];
+	uint32_t     count;
+	uint32_t     code;
+	uint8_t      decoder;
+};
+
+struct trial {
+	uint32_t end;     /* Index of the first sample after this trial. */
+	uint16_t waveform;
+};
+
+struct result {
+	uint32_t hits;
+	uint32_t errors;
+};
+
+struct steps {
+	uint64_t total;
+	uint32_t max;
+};
+
+static struct waveform waveforms[32];
+static uint32_t nwaveforms;
+
+static uint8_t      samples[MAX_SAMPLES];
+static uint32_t     nsamples;
+static struct trial trials[MAX_TRIALS];
+static uint32_t     ntrials;
+
+static uint32_t jitter_us;
+static int32_t  drift_ppm;
+static uint32_t noise_permille;
+static uint64_t rng_state = 1;
+static bool     verbose;
+
+/* The AR100 clock while asleep, and the measured cost of a decoder step. */
+static uint32_t cpu_khz = CPUCLK_kHz >> CONFIG_CPUS_CLK_SLEEP_SHIFT;
+static double   cycles_per_step;
+
+/*
+ * The decoders log scan codes using debug(); only show them if asked.
+ */
+void
+log(const char *fmt, ...)
+{
+	va_list args;
+
+	if (!verbose)
+		return;
+	va_start(args, fmt);
+	vprintf(fmt + 1, args);
+	va_end(args);
+	putchar('\n');
+}
+
+static uint32_t
+rng(void)
+{
+	/* xorshift64* */
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+
+	return (rng_state * 0x2545f4914f6cdd1dULL) >> 32;
+}
+
+/**
+ * Append a pulse to a waveform, merging it with the previous pulse if both
+ * have the same level.
+ */
+static void
+emit(struct waveform *w, bool mark, uint32_t us)
+{
+	if (w->count && w->pulses[w->count - 1].mark == mark) {
+		w->pulses[w->count - 1].us += us;
+		return;
+	}
+	if (w->count == MAX_PULSES) {
+		fprintf(stderr, "%s: Too many pulses\n", w->name);
+		exit(EXIT_FAILURE);
+	}
+	w->pulses[w->count].mark = mark;
+	w->pulses[w->count].us   = us;
+	w->count++;
+}
+
+static struct waveform *
+new_waveform(const char *name, uint8_t decoder, uint32_t code)
+{
+	struct waveform *w = &waveforms[nwaveforms++];
+
+	w->name    = name;
+	w->decoder = decoder;
+	w->code    = code;
+	w->count   = 0;
+
+	return w;
+}
+
+/**
+ * Finish a waveform with an idle period. A final mark, like the start of
+ * the next repeat, ends the idle space for decoders that need to see it.
+ */
+static void
+finish_waveform(struct waveform *w)
+{
+	emit(w, false, IDLE_US);
+	emit(w, true, 560);
+	emit(w, false, IDLE_US);
+}
+
+static void
+make_nec(const char *name, uint8_t decoder, uint32_t raw, uint32_t code)
+{
+	struct waveform *w = new_waveform(name, decoder, code);
+
+	emit(w, false, IDLE_US);
+	emit(w, true, 9000);
+	emit(w, false, 4500);
+	for (int i = 0; i < 32; ++i) {
+		emit(w, true, 563);
+		emit(w, false, raw & BIT(i) ? 1688 : 563);
+	}
+	emit(w, true, 563);
+	finish_waveform(w);
+}
+
+/* Manchester-encode a bit; RC5 sends a one as space-mark, RC6 as mark-space. */
+static void
+emit_manchester(struct waveform *w, bool bit, bool one_is_mark, uint32_t us)
+{
+	emit(w, bit == one_is_mark, us);
+	emit(w, bit != one_is_mark, us);
+}
+
+static void
+make_rc5(const char *name, uint8_t address, uint8_t command, bool toggle)
+{
+	uint32_t code = address << 8 | command;
+	uint32_t bits = 1 << 13 | !(command & BIT(6)) << 12 | toggle << 11 |
+	                (address & 0x1f) << 6 | (command & 0x3f);
+	struct waveform *w = new_waveform(name, DEC_RC5, code);
+
+	emit(w, false, IDLE_US);
+	for (int i = 13; i >= 0; --i)
+		emit_manchester(w, bits & BIT(i), false, 889);
+	finish_waveform(w);
+}
+
+static void
+make_rc6(const char *name, uint8_t mode, uint32_t data, uint8_t nbits,
+         uint32_t code)
+{
+	struct waveform *w = new_waveform(name, DEC_RC6, code);
+
+	emit(w, false, IDLE_US);
+	emit(w, true, 2667);
+	emit(w, false, 889);
+	emit_manchester(w, true, true, 444);
+	for (int i = 2; i >= 0; --i)
+		emit_manchester(w, mode & BIT(i), true, 444);
+	/* The trailer bit has double width. */
+	emit_manchester(w, false, true, 889);
+	for (int i = nbits - 1; i >= 0; --i)
+		emit_manchester(w, data & BIT(i), true, 444);
+	finish_waveform(w);
+}
+
+static void
+make_sirc(const char *name, uint32_t data, uint8_t nbits, uint32_t code)
+{
+	struct waveform *w = new_waveform(name, DEC_SIRC, code);
+
+	emit(w, false, IDLE_US);
+	emit(w, true, 2400);
+	for (int i = 0; i < nbits; ++i) {
+		emit(w, false, 600);
+		emit(w, true, data & BIT(i) ? 1200 : 600);
+	}
+	finish_waveform(w);
+}
+
+static void
+make_builtin_waveforms(void)
+{
+	make_nec("nec", DEC_NEC, 0xf708fb04, 0x0408);
+	make_nec("necx", DEC_NECX, 0xe51abf40, 0x40bf1a);
+	make_rc5("rc5", 0x05, 0x0c, false);
+	make_rc5("rc5x", 0x1f, 0x7f, true);
+	make_rc6("rc6-0", 0, 0x0c2d, 16, 0x0c2d);
+	make_rc6("rc6-mce", 6, 0x800f840c, 32, 0x800f040c);
+	make_sirc("sirc-12", 1 << 7 | 0x15, 12, 0x010015);
+	make_sirc("sirc-15", 0x9a << 7 | 0x2a, 15, 0x9a002a);
+	make_sirc("sirc-20", 0xf3 << 12 | 3 << 7 | 0x55, 20, 0x03f355);
+}
+
+/**
+ * Load a waveform recorded in the LIRC mode2 text format. A comment line of
+ * the form "# expect <decoder> <code>" gives the expected scan code.
+ */
+static void
+load_waveform(const char *path)
+{
+	struct waveform *w;
+	char line[128], name[16];
+	FILE *f;
+
+	if (nwaveforms == ARRAY_SIZE(waveforms)) {
+		fprintf(stderr, "%s: Too many waveforms\n", path);
+		exit(EXIT_FAILURE);
+	}
+	if (!(f = fopen(path, "r"))) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+
+	w = new_waveform(path, DECODERS, 0);
+	emit(w, false, IDLE_US);
+	while (fgets(line, sizeof(line), f)) {
+		unsigned long value;
+
+		if (sscanf(line, "# expect %15s %lx", name, &value) == 2) {
+			for (uint8_t i = 0; i < DECODERS; ++i) {
+				if (!strcmp(name, decoders[i].name))
+					w->decoder = i;
+			}
+			w->code = value;
+		} else if (sscanf(line, "pulse %lu", &value) == 1) {
+			emit(w, true, value);
+		} else if (sscanf(line, "space %lu", &value) == 1 ||
+		           sscanf(line, "timeout %lu", &value) == 1) {
+			emit(w, false, value);
+		}
+	}
+	fclose(f);
+	finish_waveform(w);
+}
+
+/**
+ * Convert a pulse to FIFO samples, as the receiver would.
+ */
+static void
+push_samples(bool mark, uint64_t us)
+{
+	uint32_t clocks = (us * CONFIG_CIR_CLK_RATE + 500000) / 1000000;
+
+	while (clocks) {
+		uint32_t width = clocks < SAMPLE_MAX_WIDTH ?
+		                 clocks : SAMPLE_MAX_WIDTH;
+
+		if (nsamples == MAX_SAMPLES) {
+			fprintf(stderr, "Too many samples\n");
+			exit(EXIT_FAILURE);
+		}
+		samples[nsamples++] = mark << 7 | width;
+		clocks -= width;
+	}
+}
+
+/**
+ * Apply clock drift, jitter, and noise to a waveform, and append the
+ * resulting samples to the stream.
+ */
+static void
+push_trial(uint16_t index)
+{
+	const struct waveform *w = &waveforms[index];
+	uint32_t glitch = UINT32_MAX;
+
+	/* Pick one pulse to be interrupted by a short glitch. */
+	if (rng() % 1000 < noise_permille)
+		glitch = rng() % w->count;
+
+	for (uint32_t i = 0; i < w->count; ++i) {
+		int64_t us = w->pulses[i].us;
+
+		us += us * drift_ppm / 1000000;
+		if (jitter_us)
+			us += (int64_t)(rng() % (2 * jitter_us + 1)) -
+			      jitter_us;
+		if (us < 1)
+			us = 1;
+		if (i == glitch) {
+			uint32_t width = 50 + rng() % 100;
+
+			push_samples(w->pulses[i].mark, us / 2);
+			push_samples(!w->pulses[i].mark, width);
+			push_samples(w->pulses[i].mark, us - us / 2);
+		} else {
+			push_samples(w->pulses[i].mark, us);
+		}
+	}
+
+	trials[ntrials].end      = nsamples;
+	trials[ntrials].waveform = index;
+	ntrials++;
+}
+
+/**
+ * Run one decoder over the whole sample stream, counting correct and
+ * incorrect scan codes for each waveform.
+ *
+ * Host time says little about the AR100, so count decoder steps instead.
+ * Each step is one call to the decoder, as made by cir_poll().
+ */
+static void
+run_decoder(uint8_t decoder, struct result *results, struct steps *steps)
+{
+	uint32_t (*decode)(struct cir_dec_ctx *ctx) = decoders[decoder].decode;
+	struct cir_dec_ctx ctx = { 0 };
+	uint32_t trial = 0;
+	uint32_t *codes;
+
+	codes = calloc(nsamples, sizeof(*codes));
+	if (!codes) {
+		perror("calloc");
+		exit(EXIT_FAILURE);
+	}
+
+	for (uint32_t i = 0; i < nsamples; ++i) {
+		uint32_t count = 0;
+
+		ctx.pulse = samples[i] >> 7;
+		ctx.width = samples[i] & SAMPLE_MAX_WIDTH;
+		while (ctx.width > 0) {
+			uint32_t code = decode(&ctx);
+
+			if (code)
+				codes[i] = code;
+			count++;
+		}
+		steps->total += count;
+		if (count > steps->max)
+			steps->max = count;
+	}
+
+	for (uint32_t i = 0; i < nsamples; ++i) {
+		const struct waveform *w;
+
+		while (i >= trials[trial].end)
+			trial++;
+		w = &waveforms[trials[trial].waveform];
+		if (!codes[i] || w->decoder != decoder)
+			continue;
+		if (codes[i] == w->code)
+			results[trials[trial].waveform].hits++;
+		else
+			results[trials[trial].waveform].errors++;
+	}
+
+	free(codes);
+}
+
+static void
+usage(const char *name)
+{
+	printf("CIR decoder test harness (%u Hz sample clock)\n",
+	       CONFIG_CIR_CLK_RATE);
+	printf("usage: %s [-v] [-c cycles] [-d ppm] [-f kHz] [-j us] "
+	       "[-n permille] [-r repeats] [-s seed] [mode2 file...]\n",
+	       name);
+	puts("  -c  AR100 cycles per decoder step, from DEBUG_TRACE_CIR");
+	puts("  -d  Clock drift applied to every pulse, in ppm");
+	printf("  -f  AR100 clock rate while asleep, in kHz (default %u)\n",
+	       cpu_khz);
+	puts("  -j  Maximum random jitter added to every pulse, in us");
+	puts("  -n  Chance of a glitch within each frame, per thousand");
+	puts("  -r  Number of times each waveform is sent");
+	puts("  -s  Random number generator seed");
+	puts("  -v  Print each decoded scan code");
+	puts("Without files, synthetic frames for every protocol are used.");
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct result results[DECODERS][ARRAY_SIZE(waveforms)] = { 0 };
+	struct steps steps[DECODERS] = { 0 };
+	uint64_t clocks = 0, total = 0;
+	double us_per_sample, budget;
+	uint32_t repeats = 1000;
+	bool failed = false;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "c:d:f:hj:n:r:s:v")) != -1) {
+		switch (opt) {
+		case 'c':
+			cycles_per_step = strtod(optarg, NULL);
+			break;
+		case 'd':
+			drift_ppm = strtol(optarg, NULL, 0);
+			break;
+		case 'f':
+			cpu_khz = strtoul(optarg, NULL, 0);
+			break;
+		case 'j':
+			jitter_us = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			noise_permille = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			repeats = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			rng_state = strtoull(optarg, NULL, 0) | 1;
+			break;
+		case 'v':
+			verbose = true;
+			break;
+		case 'h':
+			usage(argv[0]);
+			return EXIT_SUCCESS;
+		default:
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (optind < argc) {
+		while (optind < argc)
+			load_waveform(argv[optind++]);
+	} else {
+		make_builtin_waveforms();
+	}
+
+	for (uint32_t r = 0; r < repeats; ++r) {
+		for (uint16_t i = 0; i < nwaveforms; ++i) {
+			if (ntrials == MAX_TRIALS) {
+				fprintf(stderr, "Too many trials\n");
+				return EXIT_FAILURE;
+			}
+			push_trial(i);
+		}
+	}
+	for (uint32_t i = 0; i < nsamples; ++i)
+		clocks += samples[i] & SAMPLE_MAX_WIDTH;
+
+	for (uint8_t d = 0; d < DECODERS; ++d) {
+		run_decoder(d, results[d], &steps[d]);
+		total += steps[d].total;
+	}
+
+	printf("Sample clock: %u Hz, drift: %d ppm, jitter: %u us, "
+	       "noise: %u/1000\n", CONFIG_CIR_CLK_RATE, drift_ppm,
+	       jitter_us, noise_permille);
+	printf("\n%-16s %-5s %8s %8s %8s\n",
+	       "waveform", "dec", "sent", "decoded", "errors");
+	for (uint16_t i = 0; i < nwaveforms; ++i) {
+		const struct waveform *w = &waveforms[i];
+		const struct result *res;
+
+		if (w->decoder == DECODERS) {
+			printf("%-16s %-5s %8u %8s %8s\n", w->name, "-",
+			       repeats, "-", "-");
+			continue;
+		}
+		res = &results[w->decoder][i];
+		printf("%-16s %-5s %8u %8u %8u\n", w->name,
+		       decoders[w->decoder].name, repeats, res->hits,
+		       res->errors);
+		if (!jitter_us && !drift_ppm && !noise_permille &&
+		    (res->hits != repeats || res->errors))
+			failed = true;
+	}
+
+	/*
+	 * Report the work done per FIFO sample in decoder steps, which do not
+	 * depend on the host. The firmware runs every enabled decoder on each
+	 * sample, so "all" is the worst case with every decoder enabled.
+	 *
+	 * Given the cost of a step as measured on the AR100, also estimate the
+	 * cycles spent per sample, and compare them with the cycles available
+	 * while the receiver produces that sample. Decoding keeps up with the
+	 * FIFO as long as the load stays below 100%.
+	 */
+	us_per_sample = 1e6 * clocks / CONFIG_CIR_CLK_RATE / nsamples;
+	budget        = us_per_sample * cpu_khz / 1000;
+	printf("\n%u samples, %.1f us of signal per sample\n", nsamples,
+	       us_per_sample);
+	if (cycles_per_step) {
+		printf("%.0f AR100 cycles per sample at %u kHz, "
+		       "%.1f cycles per step\n", budget, cpu_khz,
+		       cycles_per_step);
+	} else {
+		puts("Pass -c with the cycles per step measured by "
+		     "DEBUG_TRACE_CIR to estimate the AR100 load.");
+	}
+	printf("\n%-5s %12s %12s %14s %8s\n", "dec", "steps/sample",
+	       "max steps", "cycles/sample", "load");
+	for (uint8_t d = 0; d <= DECODERS; ++d) {
+		double per_sample = (d < DECODERS ? steps[d].total : total) /
+		                    (double)nsamples;
+		double cycles     = per_sample * cycles_per_step;
+
+		printf("%-5s %12.2f ", d < DECODERS ? decoders[d].name : "all",
+		       per_sample);
+		if (d < DECODERS)
+			printf("%12u ", steps[d].max);
+		else
+			printf("%12s ", "-");
+		if (cycles_per_step)
+			printf("%14.0f %7.2f%%\n", cycles,
+			       100 * cycles / budget);
+		else
+			printf("%14s %8s\n", "-", "-");
+	}
+
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
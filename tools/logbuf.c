@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <compiler.h>
+#include <config.h>
+#include <kconfig.h>
+#include <log_buffer.h>
+#include <mmio.h>
+#include <util.h>
+#include <platform/memory.h>
+
+#ifndef PAGESIZE
+#define PAGESIZE          0x1000
+#endif
+#define PAGE_BASE(addr)   ((addr) & ~(PAGESIZE - 1))
+#define PAGE_OFFSET(addr) ((addr) & (PAGESIZE - 1))
+
+#define POLL_INTERVAL_NS  100000000 /* 100ms */
+
+#define HEADER_REG(member) (log_buf + offsetof(struct log_buffer, member))
+
+static uintptr_t log_buf;
+
+/**
+ * Print log buffer contents written since the given count was read.
+ *
+ * @return The current count of bytes written.
+ */
+static uint32_t
+print_new_output(uint32_t last)
+{
+	uint32_t count = mmio_read_32(HEADER_REG(count));
+	uint32_t index = mmio_read_32(HEADER_REG(index));
+	uint32_t size  = mmio_read_32(HEADER_REG(size));
+	uint32_t avail = count - last;
+
+	if (index >= size)
+		return count;
+	if (avail > size) {
+		printf("\n[%u bytes lost]\n", avail - size);
+		avail = size;
+	}
+
+	index = (index + size - avail) % size;
+	while (avail--) {
+		putchar(mmio_read_8(HEADER_REG(data) + index));
+		if (++index == size)
+			index = 0;
+	}
+	fflush(stdout);
+
+	return count;
+}
+
+int
+main(int argc, char *argv[])
+{
+	bool follow = false;
+	uint32_t last = 0;
+	void *map;
+	int fd;
+
+	if (argc > 1 && strcmp("-f", argv[1]) == 0) {
+		follow = true;
+	} else if (argc > 1) {
+		puts("SCP firmware log buffer reader for " CONFIG_PLATFORM);
+		printf("usage: %s [--help] [-f]\n", argv[0]);
+		return strcmp("--help", argv[1]) ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if (!CONFIG(DEBUG_LOG_BUFFER)) {
+		puts("The log buffer is disabled in this configuration");
+		return EXIT_FAILURE;
+	}
+
+	fd = open("/dev/mem", O_RDONLY | O_SYNC);
+	if (fd < 0) {
+		perror("Failed to open /dev/mem");
+		return EXIT_FAILURE;
+	}
+	map = mmap(NULL, PAGESIZE * 2, PROT_READ, MAP_SHARED,
+	           fd, PAGE_BASE(SRAM_A2_OFFSET + LOG_BUF_BASE));
+	if (map == MAP_FAILED) {
+		perror("Failed to mmap SRAM A2");
+		return EXIT_FAILURE;
+	}
+	close(fd);
+
+	log_buf = (uintptr_t)map + PAGE_OFFSET(SRAM_A2_OFFSET + LOG_BUF_BASE);
+	if (mmio_read_32(HEADER_REG(magic)) != LOG_BUFFER_MAGIC) {
+		puts("The log buffer has not been initialized");
+		return EXIT_FAILURE;
+	}
+
+	/* Print everything currently in the buffer. */
+	if ((last = mmio_read_32(HEADER_REG(count))) >
+	    mmio_read_32(HEADER_REG(size)))
+		last -= mmio_read_32(HEADER_REG(size));
+	else
+		last = 0;
+	last = print_new_output(last);
+
+	while (follow) {
+		struct timespec ts = { .tv_nsec = POLL_INTERVAL_NS };
+		uint32_t count;
+
+		nanosleep(&ts, NULL);
+
+		/* The firmware restarted and reinitialized the buffer. */
+		if ((count = mmio_read_32(HEADER_REG(count))) < last)
+			last = 0;
+		if (count != last)
+			last = print_new_output(last);
+	}
+
+	munmap(map, PAGESIZE * 2);
+
+	return EXIT_SUCCESS;
+}
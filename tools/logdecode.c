@@ -0,0 +1,308 @@
+/*
+ * Copyright © 2022 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <elf.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <util.h>
+
+/* These values must match those in common/debug.c and debug.h. */
+#define LOG_RECORD_MAGIC 0xff
+#define LOG_MAX_ARGS     7
+
+struct image {
+	const uint8_t *data;
+	size_t         size;
+	bool           big_endian;
+	const uint8_t *shdrs;
+	uint32_t       shentsize;
+	uint32_t       shnum;
+	const char    *strings;
+	uint32_t       strings_size;
+};
+
+static const char *const prefixes[] = {
+	"SCP/ERR: ",
+	"SCP/WRN: ",
+	"SCP/INF: ",
+	"SCP/DBG: ",
+};
+
+static uint32_t
+get_field(const struct image *img, const void *p, size_t size)
+{
+	const uint8_t *b = p;
+	uint32_t val = 0;
+
+	for (size_t i = 0; i < size; ++i) {
+		size_t shift = img->big_endian ? size - 1 - i : i;
+		val |= (uint32_t)b[i] << (8 * shift);
+	}
+
+	return val;
+}
+
+#define FIELD(img, ptr, type, member) \
+	get_field(img, (ptr) + offsetof(type, member), \
+	          sizeof(((type *)0)->member))
+
+static const uint8_t *
+section_header(const struct image *img, uint32_t index)
+{
+	return img->shdrs + index * img->shentsize;
+}
+
+static int
+load_image(const char *path, struct image *img)
+{
+	const uint8_t *shstrtab;
+	struct stat st;
+	uint32_t shoff, shstrndx;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		perror("Failed to open ELF file");
+		return -1;
+	}
+	if (fstat(fd, &st)) {
+		perror("Failed to stat ELF file");
+		return -1;
+	}
+	img->size = st.st_size;
+	img->data = mmap(NULL, img->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (img->data == MAP_FAILED) {
+		perror("Failed to mmap ELF file");
+		return -1;
+	}
+	close(fd);
+
+	if (img->size < sizeof(Elf32_Ehdr) ||
+	    memcmp(img->data, ELFMAG, SELFMAG) ||
+	    img->data[EI_CLASS] != ELFCLASS32) {
+		fputs("Not a 32-bit ELF file\n", stderr);
+		return -1;
+	}
+	img->big_endian = img->data[EI_DATA] == ELFDATA2MSB;
+
+	shoff          = FIELD(img, img->data, Elf32_Ehdr, e_shoff);
+	img->shentsize = FIELD(img, img->data, Elf32_Ehdr, e_shentsize);
+	img->shnum     = FIELD(img, img->data, Elf32_Ehdr, e_shnum);
+	shstrndx       = FIELD(img, img->data, Elf32_Ehdr, e_shstrndx);
+	if (shoff + img->shnum * img->shentsize > img->size ||
+	    shstrndx >= img->shnum) {
+		fputs("Invalid section headers\n", stderr);
+		return -1;
+	}
+	img->shdrs = img->data + shoff;
+	shstrtab   = img->data + FIELD(img, section_header(img, shstrndx),
+	                               Elf32_Shdr, sh_offset);
+
+	for (uint32_t i = 0; i < img->shnum; ++i) {
+		const uint8_t *sh = section_header(img, i);
+		const char *name  = (const char *)shstrtab +
+		                    FIELD(img, sh, Elf32_Shdr, sh_name);
+
+		if (strcmp(name, ".log_strings"))
+			continue;
+		img->strings = (const char *)img->data +
+		               FIELD(img, sh, Elf32_Shdr, sh_offset);
+		img->strings_size = FIELD(img, sh, Elf32_Shdr, sh_size);
+
+		return 0;
+	}
+
+	fputs("No tokenized log strings found\n", stderr);
+	return -1;
+}
+
+/**
+ * Find a NUL-terminated string at some address in the firmware's memory.
+ */
+static const char *
+lookup_string(const struct image *img, uint32_t addr)
+{
+	for (uint32_t i = 0; i < img->shnum; ++i) {
+		const uint8_t *sh = section_header(img, i);
+		uint32_t base     = FIELD(img, sh, Elf32_Shdr, sh_addr);
+		uint32_t size     = FIELD(img, sh, Elf32_Shdr, sh_size);
+		const char *data;
+
+		if (!(FIELD(img, sh, Elf32_Shdr, sh_flags) & SHF_ALLOC) ||
+		    FIELD(img, sh, Elf32_Shdr, sh_type) != SHT_PROGBITS)
+			continue;
+		if (addr < base || addr - base >= size)
+			continue;
+		data = (const char *)img->data +
+		       FIELD(img, sh, Elf32_Shdr, sh_offset) + (addr - base);
+		if (!memchr(data, 0, size - (addr - base)))
+			break;
+
+		return data;
+	}
+
+	return NULL;
+}
+
+/**
+ * Format a record the same way as the untokenized log() function.
+ */
+static void
+print_record(const struct image *img, uint32_t token,
+             const uint32_t *args, uint32_t nargs)
+{
+	const char *fmt;
+	uint32_t arg, level;
+	char c;
+
+	if (token >= img->strings_size ||
+	    !memchr(img->strings + token, 0, img->strings_size - token)) {
+		printf("<unknown log token 0x%08x>\n", token);
+		return;
+	}
+	fmt = img->strings + token;
+
+	level = (uint8_t)*fmt - 1;
+	if (level < ARRAY_SIZE(prefixes)) {
+		fputs(prefixes[level], stdout);
+		++fmt;
+	}
+	while ((c = *fmt++)) {
+		bool zero = false;
+		int width = 0;
+
+		if (c != '%') {
+			putchar(c);
+			continue;
+		}
+		if (*fmt == '%') {
+			putchar(*fmt++);
+			continue;
+		}
+		/* Missing arguments are printed as zero. */
+		arg = 0;
+		if (nargs) {
+			arg = *args++;
+			--nargs;
+		}
+		while ((c = *fmt++) == '0' || (c >= '1' && c <= '9')) {
+			if (c == '0' && width == 0)
+				zero = true;
+			else
+				width = 10 * width + (c - '0');
+		}
+		switch (c) {
+		case 'c':
+			putchar(arg);
+			break;
+		case 'd':
+		case 'i':
+			printf(zero ? "%0*d" : "%*d", width, (int32_t)arg);
+			break;
+		case 'p':
+			printf("0x%08x", arg);
+			break;
+		case 'x':
+			printf(zero ? "%0*x" : "%*x", width, arg);
+			break;
+		case 's': {
+			const char *s = lookup_string(img, arg);
+			if (s)
+				fputs(s, stdout);
+			else
+				printf("<0x%08x>", arg);
+			break;
+		}
+		case 'u':
+			printf(zero ? "%0*u" : "%*u", width, arg);
+			break;
+		default:
+			/* Malformed format string. */
+			return;
+		}
+	}
+	if (level < ARRAY_SIZE(prefixes))
+		putchar('\n');
+}
+
+static bool
+read_word(FILE *in, uint32_t *word)
+{
+	*word = 0;
+	for (int i = 0; i < 4; ++i) {
+		int c = getc(in);
+		if (c == EOF)
+			return false;
+		/* Words are sent least significant byte first. */
+		*word |= (uint32_t)c << (8 * i);
+	}
+
+	return true;
+}
+
+int
+main(int argc, char *argv[])
+{
+	struct image img = { 0 };
+	FILE *in = stdin;
+	int c;
+
+	if (argc < 2 || strcmp("--help", argv[1]) == 0) {
+		puts("Tokenized log decoder");
+		printf("usage: %s [--help] <scp.elf> [input]\n", argv[0]);
+		return argc < 2 ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if (load_image(argv[1], &img))
+		return EXIT_FAILURE;
+	if (argc > 2 && !(in = fopen(argv[2], "rb"))) {
+		perror("Failed to open input");
+		return EXIT_FAILURE;
+	}
+
+	/* Keep up with live output from a serial port. */
+	setvbuf(stdout, NULL, _IOLBF, 0);
+
+	while ((c = getc(in)) != EOF) {
+		uint32_t args[LOG_MAX_ARGS], nargs, token;
+
+		/* Pass through everything that is not a log record. */
+		if (c != LOG_RECORD_MAGIC) {
+			if (c != '\r')
+				putchar(c);
+			continue;
+		}
+		if ((c = getc(in)) == EOF)
+			break;
+		nargs = c;
+		if (nargs > LOG_MAX_ARGS) {
+			/* Not a valid record; resynchronize. */
+			continue;
+		}
+		if (!read_word(in, &token))
+			break;
+		for (uint32_t i = 0; i < nargs; ++i) {
+			if (!read_word(in, &args[i]))
+				goto out;
+		}
+		print_record(&img, token, args, nargs);
+	}
+
+out:
+	if (in != stdin)
+		fclose(in);
+	munmap((void *)img.data, img.size);
+
+	return EXIT_SUCCESS;
+}